@@ -0,0 +1,73 @@
+/** PCF2131 RTC operation sample
+ *  
+ *  Measures time to read the time registers by rtc_time() on each bus speed profile
+ *
+ *  *** IMPORTANT ***
+ *  *** TO USE "SPI INTERFACE", COMMENT OUT THE LINE OF "#define INTERFACE_I2C"
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCF2131:
+ *    https://www.nxp.com/products/peripherals-and-logic/signal-chain/real-time-clocks/rtcs-with-temperature-compensation/nano-power-highly-accurate-rtc-with-integrated-quartz-crystal:PCF2131   
+ */
+
+#include <PCF2131_I2C.h>
+#include <PCF2131_SPI.h>
+
+#define INTERFACE_I2C
+
+#ifdef INTERFACE_I2C
+PCF2131_I2C rtc;
+#else
+PCF2131_SPI rtc;
+#endif
+
+const int repeat = 100;
+const char* profile_name[] = { "STANDARD", "FAST    ", "MAXIMUM " };
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial)
+    ;
+
+#ifdef INTERFACE_I2C
+  Serial.println("\n***** Hello, PCF2131! (I2C interface) *****");
+  Wire.begin();
+#else
+  Serial.println("\n***** Hello, PCF2131! (SPI interface) *****");
+  SPI.begin();
+  pinMode(SS, OUTPUT);  //  Required for UNO R4
+#endif
+
+  rtc.begin();
+
+  for (int p = RTC_NXP::BUS_SPEED_STANDARD; p <= RTC_NXP::BUS_SPEED_MAXIMUM; p++) {
+    rtc.bus_profile((RTC_NXP::bus_speed)p);
+
+    unsigned long start = micros();
+
+    for (int i = 0; i < repeat; i++)
+      rtc.rtc_time();
+
+    unsigned long elapsed = micros() - start;
+
+    Serial.print(profile_name[p]);
+    Serial.print(" : requested clock = ");
+    Serial.print(rtc.bus_clock());
+    Serial.print(" Hz, rtc_time() = ");
+    Serial.print((float)elapsed / repeat);
+    Serial.print(" us");
+#ifdef INTERFACE_I2C
+    Serial.print(", errors = ");
+    Serial.print(rtc.errors());
+    Serial.print(", fallbacks = ");
+    Serial.print(rtc.fallbacks());
+#endif
+    Serial.println("");
+  }
+}
+
+void loop() {
+}
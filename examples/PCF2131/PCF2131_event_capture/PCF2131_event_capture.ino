@@ -0,0 +1,96 @@
+/** PCF2131 RTC operation sample
+ *  
+ *  Demonstrates RTC_event_capture: timestamping interrupt edges in microsecond resolution.
+ *  INT_A gives every second interrupt for RTC_timebase which keeps the reference of RTC time.
+ *  INT_B gives alarm and timestamp interrupts. The edges are captured in ISR without bus access,
+ *  then the events are taken in loop() with interrupt flags of the RTC.
+ *
+ *  *** IMPORTANT ***
+ *  *** TO RUN THIS SKETCH ON ARDUINO UNO R3 AND PCF2131-ARD BOARDS, PIN8 and PIN9 MUST BE SHORTED TO PIN2 and PIN3 (RESPECTIVELY) TO HANDLE INTERRUPT CORRECTLY
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCF2131:
+ *    https://www.nxp.com/products/peripherals-and-logic/signal-chain/real-time-clocks/rtcs-with-temperature-compensation/nano-power-highly-accurate-rtc-with-integrated-quartz-crystal:PCF2131   
+ */
+
+#include <PCF2131_I2C.h>
+#include <RTC_timebase.h>
+#include <RTC_event_capture.h>
+
+PCF2131_I2C rtc;
+RTC_timebase timebase(rtc);
+
+RTC_event_capture::event event_buffer[8];
+RTC_event_capture capture(event_buffer, 8);
+
+const uint8_t intPin0 = 2;
+const uint8_t intPin1 = 3;
+
+void pin_int_callback0() {
+  timebase.edge();
+}
+
+void pin_int_callback1() {
+  capture.capture(1);
+}
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial)
+    ;
+
+  Serial.println("\n***** Hello, PCF2131! (RTC_event_capture) *****");
+  Wire.begin();
+
+  rtc.begin();
+
+  timebase.begin();
+
+  rtc.int_clear();
+  pinMode(intPin0, INPUT_PULLUP);
+  pinMode(intPin1, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(intPin0), pin_int_callback0, FALLING);
+  attachInterrupt(digitalPinToInterrupt(intPin1), pin_int_callback1, FALLING);
+
+  rtc.timestamp(1, PCF2131_base::LAST, 1);
+  rtc.periodic_interrupt_enable(PCF2131_base::EVERY_SECOND);
+  rtc.alarm(PCF2131_base::SECOND, 37, 1);
+}
+
+void loop() {
+  RTC_event_capture::event e;
+  bool flags_to_clear = false;
+
+  if (timebase.update()) {
+    capture.sync(timebase);
+    flags_to_clear = true;
+  }
+
+  while (capture.read(e)) {
+    char s[12];
+    uint8_t status[3];
+
+    rtc.int_clear(status);
+    flags_to_clear = false;
+
+    sprintf(s, ".%06ld", e.usec);
+
+    Serial.print("event at ");
+    Serial.print(e.sec);
+    Serial.print(s);
+    Serial.print(" (seconds since 2000-01-01)");
+
+    if (status[0] & 0x10)
+      Serial.print(" alarm");
+    if (status[2] & 0x80)
+      Serial.print(" timestamp1");
+
+    Serial.println("");
+  }
+
+  if (flags_to_clear)
+    rtc.int_clear();
+}
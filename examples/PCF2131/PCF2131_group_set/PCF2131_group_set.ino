@@ -0,0 +1,81 @@
+/** PCF2131 RTC operation sample
+ *  
+ *  Demonstrates RTC_group: setting time of several RTCs to start at same instant.
+ *  PCF2131 and PCF85263A on same I2C bus are preloaded with the clock stopped and released back-to-back.
+ *  Residual skew between the RTCs is measured on every 10 seconds.
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCF2131:
+ *    https://www.nxp.com/products/peripherals-and-logic/signal-chain/real-time-clocks/rtcs-with-temperature-compensation/nano-power-highly-accurate-rtc-with-integrated-quartz-crystal:PCF2131   
+ */
+
+#include <PCF2131_I2C.h>
+#include <PCF85263A.h>
+#include <RTC_group.h>
+
+time_t mktime_2000(void);
+
+PCF2131_I2C rtc0;
+PCF85263A rtc1;
+
+RTC_NXP *rtcs[] = { &rtc0, &rtc1 };
+RTC_group group(rtcs, 2);
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial)
+    ;
+
+  Serial.println("\n***** Hello, PCF2131! (RTC_group) *****");
+  Wire.begin();
+
+  rtc0.begin();
+  rtc1.begin();
+
+  struct tm now_tm;
+
+  now_tm.tm_year = 2026 - 1900;
+  now_tm.tm_mon = 6 - 1;  // It needs to be '5' if June
+  now_tm.tm_mday = 27;
+  now_tm.tm_hour = 18;
+  now_tm.tm_min = 52;
+  now_tm.tm_sec = 30;
+
+  uint32_t t = mktime(&now_tm) - mktime_2000();
+
+  if (!group.preload(t))
+    Serial.println("some RTC has no STOP bit. It will be set after others");
+
+  group.release();
+
+  Serial.print("released in ");
+  Serial.print(group.release_span());
+  Serial.println(" us");
+}
+
+void loop() {
+  char s[23];
+
+  Serial.print(rtc0.iso8601(s, true));
+  Serial.print(" ");
+  Serial.print(rtc1.iso8601(s, true));
+  Serial.print(" skew: ");
+  Serial.print(group.skew_us());
+  Serial.println(" us");
+
+  delay(10000);
+}
+
+time_t mktime_2000(void) {
+  struct tm y2k_tm;
+
+  memset(&y2k_tm, 0, sizeof(y2k_tm));
+
+  y2k_tm.tm_year = 100;
+  y2k_tm.tm_mday = 1;
+
+  return mktime(&y2k_tm);
+}
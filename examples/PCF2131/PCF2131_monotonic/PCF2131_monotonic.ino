@@ -0,0 +1,84 @@
+/** PCF2131 RTC operation sample
+ *  
+ *  Demonstrates RTC_monotonic: a clock which never goes backwards, read without bus access.
+ *  RTC time is read every 10 seconds to correct the clock by slewing.
+ *  Elapsed time of loop and MCU clock error estimation are shown.
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCF2131:
+ *    https://www.nxp.com/products/peripherals-and-logic/signal-chain/real-time-clocks/rtcs-with-temperature-compensation/nano-power-highly-accurate-rtc-with-integrated-quartz-crystal:PCF2131   
+ */
+
+#include <PCF2131_I2C.h>
+#include <RTC_monotonic.h>
+
+void set_time(void);
+
+PCF2131_I2C rtc;
+RTC_monotonic mono(rtc);
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial)
+    ;
+
+  Serial.println("\n***** Hello, PCF2131! (RTC_monotonic) *****");
+  Wire.begin();
+
+  rtc.begin();
+
+  if (rtc.oscillator_stop()) {
+    Serial.println("==== oscillator_stop detected :( ====");
+    set_time();
+  } else {
+    Serial.println("---- RTC has been kept running! :) ----");
+  }
+
+  mono.begin();
+}
+
+void loop() {
+  static uint32_t next_sync = 0;
+  static uint64_t prev = mono.now_us();
+
+  uint64_t now = mono.now_us();  //  no bus access
+
+  if (now / 1000000 >= next_sync) {
+    long err = mono.sync();  //  RTC is read here
+
+    next_sync = now / 1000000 + 10;
+
+    char s[23];
+
+    Serial.print(rtc.iso8601(s, true));
+    Serial.print(" monotonic[ms]:");
+    Serial.print((uint32_t)(now / 1000));
+    Serial.print(" sync error[us]:");
+    Serial.print(err);
+    Serial.print(" MCU clock error[ppm]:");
+    Serial.print(mono.ppm());
+    Serial.print(" loop interval[us]:");
+    Serial.println((uint32_t)(now - prev));
+  }
+
+  prev = now;
+  delay(100);
+}
+
+void set_time(void) {
+  struct tm now_tm;
+
+  now_tm.tm_year = 2026 - 1900;
+  now_tm.tm_mon = 6 - 1;  // It needs to be '5' if June
+  now_tm.tm_mday = 27;
+  now_tm.tm_hour = 18;
+  now_tm.tm_min = 52;
+  now_tm.tm_sec = 30;
+
+  rtc.set(&now_tm);
+
+  Serial.println("RTC got time information");
+}
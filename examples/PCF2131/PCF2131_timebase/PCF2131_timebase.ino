@@ -0,0 +1,98 @@
+/** PCF2131 RTC operation sample
+ *  
+ *  Demonstrates RTC_timebase: a tick service on every second interrupt.
+ *  Sampling callback is called on every 10 seconds, aligned to RTC time.
+ *  Jitter of interrupt interval and latency to the service are shown.
+ *
+ *  *** IMPORTANT ***
+ *  *** TO RUN THIS SKETCH ON ARDUINO UNO R3 AND PCF2131-ARD BOARDS, PIN8 MUST BE SHORTED TO PIN2 TO HANDLE INTERRUPT CORRECTLY
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCF2131:
+ *    https://www.nxp.com/products/peripherals-and-logic/signal-chain/real-time-clocks/rtcs-with-temperature-compensation/nano-power-highly-accurate-rtc-with-integrated-quartz-crystal:PCF2131   
+ */
+
+#include <PCF2131_I2C.h>
+#include <RTC_timebase.h>
+
+void set_time(void);
+void sample(uint32_t t);
+
+PCF2131_I2C rtc;
+RTC_timebase timebase(rtc);
+
+const uint8_t intPin0 = 2;
+
+void pin_int_callback0() {
+  timebase.edge();
+}
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial)
+    ;
+
+  Serial.println("\n***** Hello, PCF2131! (RTC_timebase) *****");
+  Wire.begin();
+
+  rtc.begin();
+
+  if (rtc.oscillator_stop()) {
+    Serial.println("==== oscillator_stop detected :( ====");
+    set_time();
+  } else {
+    Serial.println("---- RTC has been kept running! :) ----");
+  }
+
+  timebase.callback(sample, 10);
+  timebase.begin();
+
+  rtc.int_clear();
+  pinMode(intPin0, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(intPin0), pin_int_callback0, FALLING);
+
+  rtc.periodic_interrupt_enable(PCF2131_base::EVERY_SECOND);
+}
+
+void loop() {
+  if (timebase.update())
+    rtc.int_clear();
+}
+
+void sample(uint32_t t) {
+  char s[20];
+
+  Serial.print(rtc.iso8601(s));
+  Serial.print(" ticks:");
+  Serial.print(timebase.ticks());
+  Serial.print(" missed:");
+  Serial.print(timebase.missed());
+  Serial.print(" jitter[us] min/max/rms:");
+  Serial.print(timebase.jitter_min());
+  Serial.print("/");
+  Serial.print(timebase.jitter_max());
+  Serial.print("/");
+  Serial.print(timebase.jitter_rms());
+  Serial.print(" latency[us] mean/max:");
+  Serial.print(timebase.latency_mean());
+  Serial.print("/");
+  Serial.println(timebase.latency_max());
+}
+
+void set_time(void) {
+  struct tm now_tm;
+
+  now_tm.tm_year = 2026 - 1900;
+  now_tm.tm_mon = 6 - 1;  // It needs to be '5' if June
+  now_tm.tm_mday = 27;
+  now_tm.tm_hour = 18;
+  now_tm.tm_min = 52;
+  now_tm.tm_sec = 30;
+
+  rtc.set(&now_tm);
+
+  Serial.println("RTC got time information");
+}
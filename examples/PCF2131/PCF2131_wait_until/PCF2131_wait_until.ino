@@ -0,0 +1,102 @@
+/** PCF2131 RTC operation sample
+ *  
+ *  Demonstrates RTC_wakeup: waiting until an RTC instant with 10 ms resolution.
+ *  A task is started at every 10 seconds + 0.50 second of RTC time.
+ *  The alarm interrupt wakes up the MCU from idle sleep (on AVR) and 100th-seconds register finishes the wait.
+ *  Nodes with RTCs set to same time start the task at same instant.
+ *
+ *  *** IMPORTANT ***
+ *  *** TO RUN THIS SKETCH ON ARDUINO UNO R3 AND PCF2131-ARD BOARDS, PIN8 MUST BE SHORTED TO PIN2 TO HANDLE INTERRUPT CORRECTLY
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCF2131:
+ *    https://www.nxp.com/products/peripherals-and-logic/signal-chain/real-time-clocks/rtcs-with-temperature-compensation/nano-power-highly-accurate-rtc-with-integrated-quartz-crystal:PCF2131   
+ */
+
+#include <PCF2131_I2C.h>
+#include <RTC_wakeup.h>
+
+#if defined(__AVR__)
+#include <avr/sleep.h>
+#endif
+
+void set_time(void);
+void idle(void);
+
+PCF2131_I2C rtc;
+RTC_wakeup wakeup(rtc, idle);
+
+const uint8_t intPin0 = 2;
+
+void pin_int_callback0() {
+  wakeup.edge();
+}
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial)
+    ;
+
+  Serial.println("\n***** Hello, PCF2131! (RTC_wakeup) *****");
+  Wire.begin();
+
+  rtc.begin();
+
+  if (rtc.oscillator_stop()) {
+    Serial.println("==== oscillator_stop detected :( ====");
+    set_time();
+  } else {
+    Serial.println("---- RTC has been kept running! :) ----");
+  }
+
+  rtc.int_clear();
+  pinMode(intPin0, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(intPin0), pin_int_callback0, FALLING);
+}
+
+void loop() {
+  time_t t = rtc.time(NULL);
+
+  t += 10 - (t % 10);  //  next 10 seconds boundary
+
+  Serial.flush();
+
+  if (!wakeup.wait_until(t, 50)) {
+    Serial.println("missed");
+    return;
+  }
+
+  unsigned long started = micros();
+  char s[23];
+
+  Serial.print("task started at ");
+  Serial.print(rtc.iso8601(s, true));
+  Serial.print(", ");
+  Serial.print(started - wakeup.edge_micros());
+  Serial.println(" us after the alarm edge");
+}
+
+void idle(void) {
+#if defined(__AVR__)
+  set_sleep_mode(SLEEP_MODE_IDLE);  //  wakes up on any interrupt
+  sleep_mode();
+#endif
+}
+
+void set_time(void) {
+  struct tm now_tm;
+
+  now_tm.tm_year = 2026 - 1900;
+  now_tm.tm_mon = 6 - 1;  // It needs to be '5' if June
+  now_tm.tm_mday = 27;
+  now_tm.tm_hour = 18;
+  now_tm.tm_min = 52;
+  now_tm.tm_sec = 30;
+
+  rtc.set(&now_tm);
+
+  Serial.println("RTC got time information");
+}
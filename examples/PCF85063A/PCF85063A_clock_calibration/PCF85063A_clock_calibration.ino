@@ -0,0 +1,62 @@
+/** PCF85063A RTC operation sample
+ *  
+ *  Demonstrates RTC_calibrator: MCU clock error measurement using 1 Hz CLKOUT.
+ *  A LED blink interval is scheduled by millis() with the measured error corrected.
+ *
+ *  *** IMPORTANT ***
+ *  *** CLKOUT PIN OF THE RTC MUST BE CONNECTED TO PIN2
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCF85063A:
+ *    https://www.nxp.com/products/peripherals-and-logic/signal-chain/real-time-clocks/rtcs-with-ic-bus/tiny-real-time-clock-calendar-with-alarm-function-and-ic-bus:PCF85063A   
+ */
+
+#include <PCF85063A.h>
+#include <RTC_calibrator.h>
+
+PCF85063A rtc;
+RTC_calibrator calibrator(1, 10);  //  1 Hz CLKOUT, measure every 10 seconds
+
+const uint8_t clkoutPin = 2;
+
+void clkout_callback() {
+  calibrator.edge();
+}
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial)
+    ;
+
+  Wire.begin();
+
+  Serial.println("\n***** Hello, PCF85063A! (RTC_calibrator) *****");
+
+  rtc.set_clock_out(RTC_NXP::FREQ_1_HZ);
+
+  pinMode(LED_BUILTIN, OUTPUT);
+  pinMode(clkoutPin, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(clkoutPin), clkout_callback, RISING);
+
+  calibrator.begin();
+}
+
+void loop() {
+  static unsigned long start = millis();
+  static unsigned long count = 0;
+
+  if (calibrator.update()) {
+    Serial.print("MCU clock error: ");
+    Serial.print(calibrator.ppm());
+    Serial.println(" ppm");
+  }
+
+  //  scheduling from start time to avoid accumulating rounding error
+  if (calibrator.mcu_ms((count + 1) * 1000UL) <= (millis() - start)) {
+    count++;
+    digitalWrite(LED_BUILTIN, count & 1);
+  }
+}
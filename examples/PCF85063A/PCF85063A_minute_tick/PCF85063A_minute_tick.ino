@@ -0,0 +1,91 @@
+/** PCF85063A RTC operation sample
+ *  
+ *  Demonstrates RTC_timebase on every minute interrupt of PCF85063A.
+ *  The interrupt is given at each minute boundary by the MI bit, 
+ *  so the alarm or the countdown timer doesn't need to be reprogrammed.
+ *  A task callback is called on every 5 minutes, aligned to RTC time.
+ *  MCU can sleep between the ticks.
+ *
+ *  PCF85063TP cannot run this sketch: it has no INT output.
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCF85063A:
+ *    https://www.nxp.com/products/peripherals-and-logic/signal-chain/real-time-clocks/rtcs-with-ic-bus/tiny-real-time-clock-calendar-with-alarm-function-and-ic-bus:PCF85063A   
+ */
+
+#include <PCF85063A.h>
+#include <RTC_timebase.h>
+
+void set_time(void);
+void task(uint32_t t);
+
+PCF85063A rtc;
+RTC_timebase timebase(rtc, 60);
+
+const uint8_t intPin = 2;
+
+void pin_int_callback() {
+  timebase.edge();
+}
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial)
+    ;
+
+  Serial.println("\n***** Hello, PCF85063A! (every minute tick) *****");
+  Wire.begin();
+
+  if (rtc.oscillator_stop()) {
+    Serial.println("==== oscillator_stop detected :( ====");
+    set_time();
+  } else {
+    Serial.println("---- RTC has been kept running! :) ----");
+  }
+
+  timebase.callback(task, 5 * 60);
+  timebase.begin();
+
+  rtc.int_clear();
+  pinMode(intPin, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(intPin), pin_int_callback, FALLING);
+
+  rtc.periodic_interrupt_enable(PCF85063A::EVERY_MINUTE);
+}
+
+void loop() {
+  if (timebase.update()) {
+    rtc.int_clear();  //  INT pin is kept LOW until TF is cleared
+
+    char s[20];
+
+    Serial.print(rtc.iso8601(s));
+    Serial.print(" tick:");
+    Serial.print(timebase.ticks());
+    Serial.print(" missed:");
+    Serial.println(timebase.missed());
+  }
+}
+
+void task(uint32_t t) {
+  Serial.print("  task on RTC time ");
+  Serial.println(t);
+}
+
+void set_time(void) {
+  struct tm now_tm;
+
+  now_tm.tm_year = 2026 - 1900;
+  now_tm.tm_mon = 6 - 1;  // It needs to be '5' if June
+  now_tm.tm_mday = 27;
+  now_tm.tm_hour = 18;
+  now_tm.tm_min = 52;
+  now_tm.tm_sec = 30;
+
+  rtc.set(&now_tm);
+
+  Serial.println("RTC got time information");
+}
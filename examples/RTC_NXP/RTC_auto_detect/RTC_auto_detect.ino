@@ -0,0 +1,76 @@
+/** RTC auto-detection sample
+ *  
+ *  This sample code is showing how to run same firmware on boards with different RTC variants.
+ *  RTC_probe checks the default I2C addresses, tells the chips apart by register map 
+ *  and creates the driver instance for the chip found. 
+ *  Found: PCF2131 (I2C), PCF85063A, PCF85063TP, PCF85263A or PCF85053A
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <RTC_probe.h>
+#include <time.h>
+
+void set_time(void);
+
+RTC_NXP* rtc;
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial)
+    ;
+
+  Wire.begin();
+
+  Serial.println("\n***** Hello, RTC! *****");
+
+  RTC_probe probe;
+  rtc = probe.create();
+
+  if (!rtc) {
+    Serial.println("==== no RTC found :( ====");
+    while (true)
+      ;
+  }
+
+  Serial.print("found ");
+  Serial.print(probe.name());
+  Serial.print(" at 0x");
+  Serial.println(probe.address(), HEX);
+
+  if (rtc->oscillator_stop()) {
+    Serial.println("==== oscillator_stop detected :( ====");
+    set_time();
+  } else {
+    Serial.println("---- RTC has been kept running! :) ----");
+  }
+}
+
+void loop() {
+  time_t current_time = 0;
+
+  current_time = rtc->time(NULL);
+  Serial.print("time : ");
+  Serial.print(current_time);
+  Serial.print(", ");
+  Serial.println(ctime(&current_time));
+
+  delay(1000);
+}
+
+void set_time(void) {
+  struct tm now_tm;
+
+  now_tm.tm_year = 2023 - 1900;
+  now_tm.tm_mon = 4 - 1;  // It needs to be '3' if April
+  now_tm.tm_mday = 7;
+  now_tm.tm_hour = 18;
+  now_tm.tm_min = 52;
+  now_tm.tm_sec = 30;
+
+  rtc->set(&now_tm);
+
+  Serial.println("RTC got time information");
+}
@@ -0,0 +1,168 @@
+/** bench: cycle count of driver operations on ATmega328P
+ *
+ *	Firmware for run_bench (simavr). Each operation is framed by markers on GPIOR registers. 
+ *	  GPIOR0 : characters of the operation label
+ *	  GPIOR1 : start of the operation
+ *	  GPIOR2 : end of the operation
+ *	run_bench takes simulator cycle counter at the markers, so the counts are exact 
+ *	and not disturbed by timers on the AVR. 
+ *	Timer0 overflow interrupt (millis()) is stopped while measuring, 
+ *	except for operations which need delay(). 
+ *	sizeof of each class (RAM for each instance) is printed to Serial before the measurement. 
+ *	Simulation ends by sleep with interrupts disabled. 
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <RTC_NXP.h>
+#include <avr/sleep.h>
+
+#define	BENCH( name, op )		do { label( name ); TIMSK0 &= ~_BV( TOIE0 ); GPIOR1 = 1; op; GPIOR2 = 1; TIMSK0 |= _BV( TOIE0 ); } while ( 0 )
+#define	BENCH_TICK( name, op )	do { label( name ); GPIOR1 = 1; op; GPIOR2 = 1; } while ( 0 )
+#define	SIZEOF( cls )			size_line( F( #cls ), sizeof( cls ) )
+
+static void label( const char* s )
+{
+	while ( *s )
+		GPIOR0	= *s++;
+}
+
+static void heading( const char* s )
+{
+	label( s );
+	GPIOR0	= '\n';
+}
+
+static void size_line( const __FlashStringHelper* name, size_t size )
+{
+	Serial.print( F( "  " ) );
+	Serial.print( name );
+	Serial.print( F( "\t" ) );
+	Serial.println( size );
+}
+
+static void sizes( void )
+{
+	Serial.println( F( "sizeof (RAM for each instance, bytes)" ) );
+	SIZEOF( PCF2131_I2C );
+	SIZEOF( PCF2131_SPI );
+	SIZEOF( PCF85053A );
+	SIZEOF( PCF85063A );
+	SIZEOF( PCF85063TP );
+	SIZEOF( PCF85263A );
+	SIZEOF( I2C_for_RTC );
+	SIZEOF( SPI_for_RTC );
+	SIZEOF( RTC_timebase );
+	SIZEOF( RTC_calibrator );
+	SIZEOF( RTC_event_capture );
+	SIZEOF( RTC_monotonic );
+	SIZEOF( RTC_wakeup );
+	SIZEOF( RTC_group );
+	SIZEOF( RTC_drift_meter );
+	SIZEOF( RTC_probe );
+	SIZEOF( RTC_bus_recorder );
+
+	//	UART interrupts must be finished before measurement
+	Serial.flush();
+}
+
+//	BCD conversions are protected in RTC_NXP
+struct bcd_codec : public RTC_NXP {
+	using RTC_NXP::bcd2dec;
+	using RTC_NXP::dec2bcd;
+};
+
+volatile uint8_t	in	= 0x59;
+volatile uint8_t	out;
+volatile time_t		t;
+
+PCF85063A	pcf85063a;
+PCF85263A	pcf85263a;
+PCF85053A	pcf85053a;
+PCF2131_I2C	pcf2131_i2c;
+PCF2131_SPI	pcf2131_spi;
+
+static void set_time( struct tm* tmp )
+{
+	tmp->tm_year	= 2024 - 1900;
+	tmp->tm_mon		= 6 - 1;
+	tmp->tm_mday	= 1;
+	tmp->tm_hour	= 12;
+	tmp->tm_min		= 34;
+	tmp->tm_sec		= 56;
+	tmp->tm_isdst	= 0;
+}
+
+static void common_ops( RTC_NXP& rtc )
+{
+	struct tm	now_tm;
+
+	set_time( &now_tm );
+	
+	BENCH( "set()", rtc.set( &now_tm ) );
+	BENCH( "rtc_time()", t = rtc.time( NULL ) );
+	BENCH( "now32()", t = rtc.now32() );
+	BENCH( "alarm( MINUTE, 30 )", rtc.alarm( RTC_NXP::MINUTE, 30 ) );
+	BENCH( "int_clear()", rtc.int_clear() );
+}
+
+void setup()
+{
+	Serial.begin( 115200 );
+	Wire.begin();
+	SPI.begin();
+	pinMode( SS, OUTPUT );
+
+#if defined( WIRE_HAS_TIMEOUT )
+	Wire.setWireTimeout( 0 );	//	no timeout: micros() is not updated while measuring
+#endif
+
+	sizes();
+
+	BENCH( "(marker)", );	//	cost of markers. run_bench subtracts this from others
+
+	heading( "RTC_NXP" );
+	BENCH( "bcd2dec()", out = bcd_codec::bcd2dec( in ) );
+	BENCH( "dec2bcd()", out = bcd_codec::dec2bcd( in ) );
+
+	heading( "PCF85063A" );
+	common_ops( pcf85063a );
+	BENCH( "timer( 1.0 )", pcf85063a.timer( 1.0 ) );
+
+	heading( "PCF85263A" );
+	common_ops( pcf85263a );
+
+	heading( "PCF85053A" );
+	common_ops( pcf85053a );
+
+	//	set() of PCF2131 includes delay( 100 ) for OTP refresh. Timer0 is kept running for it
+	struct tm	now_tm;
+	set_time( &now_tm );
+
+	heading( "PCF2131_I2C" );
+	BENCH_TICK( "set() with delay( 100 )", pcf2131_i2c.set( &now_tm ) );
+	BENCH( "rtc_time()", t = pcf2131_i2c.time( NULL ) );
+	BENCH( "now32()", t = pcf2131_i2c.now32() );
+	BENCH( "alarm( MINUTE, 30 )", pcf2131_i2c.alarm( RTC_NXP::MINUTE, 30 ) );
+	BENCH( "int_clear()", pcf2131_i2c.int_clear() );
+
+	heading( "PCF2131_SPI" );
+	BENCH_TICK( "set() with delay( 100 )", pcf2131_spi.set( &now_tm ) );
+	BENCH( "rtc_time()", t = pcf2131_spi.time( NULL ) );
+	BENCH( "now32()", t = pcf2131_spi.now32() );
+	BENCH( "alarm( MINUTE, 30 )", pcf2131_spi.alarm( RTC_NXP::MINUTE, 30 ) );
+	BENCH( "int_clear()", pcf2131_spi.int_clear() );
+
+	Serial.flush();
+
+	cli();
+	set_sleep_mode( SLEEP_MODE_PWR_DOWN );
+	sleep_enable();
+	sleep_cpu();
+}
+
+void loop()
+{
+}
@@ -0,0 +1,257 @@
+/** run_bench: runs bench.elf on simavr and reports cycle count of each operation
+ *
+ *	usage: run_bench [ELF]
+ *	  ELF : firmware built from bench.cpp (default: build/bench.elf)
+ *
+ *	ATmega328P at 16 MHz is simulated with register file targets 
+ *	on I2C (0x51, 0x53 and 0x6F) and on SPI (SS on D10). 
+ *	Bus timing is as modeled by simavr TWI and SPI. 
+ *	Serial output of the firmware is shown as it is. 
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <sim_avr.h>
+#include <sim_elf.h>
+#include <sim_io.h>
+#include <avr_twi.h>
+#include <avr_spi.h>
+#include <avr_ioport.h>
+#include <avr_uart.h>
+
+//	marker registers in data space address (ATmega328P)
+
+#define	ADDR_GPIOR0		0x3E
+#define	ADDR_GPIOR1		0x4A
+#define	ADDR_GPIOR2		0x4B
+
+static const uint32_t			frequency	= 16000000;
+static const avr_cycle_count_t	cycle_limit	= 60ULL * frequency;	//	60 seconds in simulation
+
+/** I2C target: 256 registers with auto-increment for each address */
+struct i2c_target {
+	avr_t	*avr;
+	uint8_t	reg[ 128 ][ 256 ];
+	uint8_t	ptr[ 128 ];
+	bool	present[ 128 ];
+	uint8_t	selected;	//	address byte (with R/W bit) of selected target, 0 if none
+	bool	first;		//	next written byte is register address
+};
+
+/** SPI target: register address in bit 6..0 of first byte, read flag in bit 7 */
+struct spi_target {
+	avr_t	*avr;
+	uint8_t	reg[ 128 ];
+	uint8_t	ptr;
+	bool	selected;
+	bool	first;
+	bool	read;
+};
+
+/** Markers from firmware */
+struct marker {
+	char				label[ 64 ];
+	int					length;
+	avr_cycle_count_t	start;
+	avr_cycle_count_t	overhead;
+	bool				calibrated;
+};
+
+static i2c_target	i2c;
+static spi_target	spi;
+static marker		mk;
+
+static void twi_hook( avr_irq_t *irq, uint32_t value, void *param )
+{
+	i2c_target			*p	= (i2c_target *)param;
+	avr_irq_t			*in	= avr_io_getirq( p->avr, AVR_IOCTL_TWI_GETIRQ( 0 ), TWI_IRQ_INPUT );
+	avr_twi_msg_irq_t	v;
+
+	v.u.v	= value;
+
+	if ( v.u.twi.msg & TWI_COND_STOP )
+		p->selected	= 0;
+
+	if ( v.u.twi.msg & TWI_COND_START )
+	{
+		p->selected	= 0;
+
+		if ( p->present[ v.u.twi.addr >> 1 ] )
+		{
+			p->selected	= v.u.twi.addr;
+			p->first	= !(v.u.twi.addr & 0x01);
+			avr_raise_irq( in, avr_twi_irq_msg( TWI_COND_ACK, p->selected, 1 ) );
+		}
+	}
+
+	if ( !p->selected )
+		return;
+
+	uint8_t	a	= p->selected >> 1;
+
+	if ( v.u.twi.msg & TWI_COND_WRITE )
+	{
+		avr_raise_irq( in, avr_twi_irq_msg( TWI_COND_ACK, p->selected, 1 ) );
+
+		if ( p->first )
+		{
+			p->ptr[ a ]	= v.u.twi.data;
+			p->first	= false;
+		}
+		else
+		{
+			p->reg[ a ][ p->ptr[ a ]++ ]	= v.u.twi.data;
+		}
+	}
+
+	if ( v.u.twi.msg & TWI_COND_READ )
+		avr_raise_irq( in, avr_twi_irq_msg( TWI_COND_READ, p->selected, p->reg[ a ][ p->ptr[ a ]++ ] ) );
+}
+
+static void spi_hook( avr_irq_t *irq, uint32_t value, void *param )
+{
+	spi_target	*p	= (spi_target *)param;
+	uint8_t		rx	= 0xFF;
+
+	if ( p->selected )
+	{
+		if ( p->first )
+		{
+			p->read		= value & 0x80;
+			p->ptr		= value & 0x7F;
+			p->first	= false;
+		}
+		else if ( p->read )
+		{
+			rx	= p->reg[ p->ptr++ & 0x7F ];
+		}
+		else
+		{
+			p->reg[ p->ptr++ & 0x7F ]	= value;
+		}
+	}
+
+	avr_raise_irq( avr_io_getirq( p->avr, AVR_IOCTL_SPI_GETIRQ( 0 ), SPI_IRQ_INPUT ), rx );
+}
+
+static void ss_hook( avr_irq_t *irq, uint32_t value, void *param )
+{
+	spi_target	*p	= (spi_target *)param;
+
+	p->selected	= !value;
+	p->first	= true;
+}
+
+static void uart_hook( avr_irq_t *irq, uint32_t value, void *param )
+{
+	putchar( value );
+}
+
+static void label_write( avr_t *avr, avr_io_addr_t addr, uint8_t v, void *param )
+{
+	marker	*m	= (marker *)param;
+
+	if ( v == '\n' )
+	{
+		printf( "%.*s\n", m->length, m->label );
+		m->length	= 0;
+		return;
+	}
+
+	if ( m->length < (int)sizeof( m->label ) )
+		m->label[ m->length++ ]	= v;
+}
+
+static void start_write( avr_t *avr, avr_io_addr_t addr, uint8_t v, void *param )
+{
+	marker	*m	= (marker *)param;
+
+	m->start	= avr->cycle;
+}
+
+static void end_write( avr_t *avr, avr_io_addr_t addr, uint8_t v, void *param )
+{
+	marker				*m		= (marker *)param;
+	avr_cycle_count_t	cycles	= avr->cycle - m->start;
+
+	if ( !m->calibrated )
+	{
+		m->overhead		= cycles;
+		m->calibrated	= true;
+		printf( "marker overhead %llu cycles (subtracted from results)\n", (unsigned long long)cycles );
+	}
+	else
+	{
+		cycles	-= m->overhead;
+		printf( "  %-28.*s %10llu cycles %12.2f us\n", m->length, m->label, (unsigned long long)cycles, cycles * 1e6 / frequency );
+	}
+
+	m->length	= 0;
+}
+
+int main( int argc, char *argv[] )
+{
+	const char		*path	= ( argc > 1 ) ? argv[ 1 ] : "build/bench.elf";
+	elf_firmware_t	fw;
+	avr_t			*avr;
+
+	memset( &fw, 0, sizeof( fw ) );
+
+	if ( elf_read_firmware( path, &fw ) )
+	{
+		fprintf( stderr, "cannot read %s\n", path );
+		return 1;
+	}
+
+	strcpy( fw.mmcu, "atmega328p" );
+	fw.frequency	= frequency;
+
+	if ( !(avr = avr_make_mcu_by_name( fw.mmcu )) )
+	{
+		fprintf( stderr, "simavr does not support %s\n", fw.mmcu );
+		return 1;
+	}
+
+	avr_init( avr );
+	avr_load_firmware( avr, &fw );
+
+	i2c.avr	= avr;
+	i2c.present[ 0xA2 >> 1 ]	= true;	//	PCF85063A, PCF85263A
+	i2c.present[ 0xA6 >> 1 ]	= true;	//	PCF2131
+	i2c.present[ 0xDE >> 1 ]	= true;	//	PCF85053A
+	spi.avr	= avr;
+
+	avr_irq_register_notify( avr_io_getirq( avr, AVR_IOCTL_TWI_GETIRQ( 0 ), TWI_IRQ_OUTPUT ), twi_hook, &i2c );
+	avr_irq_register_notify( avr_io_getirq( avr, AVR_IOCTL_SPI_GETIRQ( 0 ), SPI_IRQ_OUTPUT ), spi_hook, &spi );
+	avr_irq_register_notify( avr_io_getirq( avr, AVR_IOCTL_IOPORT_GETIRQ( 'B' ), 2 ), ss_hook, &spi );	//	D10
+	avr_irq_register_notify( avr_io_getirq( avr, AVR_IOCTL_UART_GETIRQ( '0' ), UART_IRQ_OUTPUT ), uart_hook, NULL );
+
+	avr_register_io_write( avr, ADDR_GPIOR0, label_write, &mk );
+	avr_register_io_write( avr, ADDR_GPIOR1, start_write, &mk );
+	avr_register_io_write( avr, ADDR_GPIOR2, end_write, &mk );
+
+	printf( "%s on %s at %lu Hz\n", path, fw.mmcu, (unsigned long)frequency );
+
+	int	state	= cpu_Running;
+
+	while ( (state != cpu_Done) && (state != cpu_Crashed) )
+	{
+		state	= avr_run( avr );
+
+		if ( avr->cycle > cycle_limit )
+		{
+			fprintf( stderr, "simulation did not finish in %llu cycles\n", (unsigned long long)cycle_limit );
+			return 1;
+		}
+	}
+
+	avr_terminate( avr );
+
+	return ( state == cpu_Done ) ? 0 : 1;
+}
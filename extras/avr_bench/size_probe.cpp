@@ -0,0 +1,32 @@
+/** size_probe: minimum sketch to see flash/RAM size of a chip class
+ *
+ *	Built with -DRTC_CLASS=<class name> for each class, and without it as the baseline. 
+ *	Wire and SPI are used in both, so the difference is the cost of the driver. 
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <RTC_NXP.h>
+
+#ifdef RTC_CLASS
+RTC_CLASS	rtc;
+#endif
+
+volatile time_t	t;
+
+void setup()
+{
+	Wire.begin();
+	SPI.begin();
+
+#ifdef RTC_CLASS
+	rtc.begin();
+	t	= rtc.time( NULL );
+#endif
+}
+
+void loop()
+{
+}
@@ -0,0 +1,235 @@
+#include <Arduino.h>
+
+#include <mutex>
+#include <thread>
+#include <chrono>
+
+HardwareSerial	Serial;
+
+static std::chrono::steady_clock::time_point	start_time	= std::chrono::steady_clock::now();
+
+static uint8_t	pin_level[ HOST_NUM_PINS ];
+static uint8_t	pin_mode[ HOST_NUM_PINS ];
+static void		(*isr_func[ HOST_NUM_PINS ])( void );
+static int		isr_mode[ HOST_NUM_PINS ];
+
+void	(*host_pin_output_hook)( uint8_t pin, uint8_t val )	= NULL;
+
+static std::mutex			int_lock;
+static thread_local bool	int_masked	= false;
+static thread_local bool	int_pending[ HOST_NUM_PINS ];
+
+unsigned long millis( void )
+{
+	return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start_time ).count();
+}
+
+unsigned long micros( void )
+{
+	return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start_time ).count();
+}
+
+void delay( unsigned long ms )
+{
+	std::this_thread::sleep_for( std::chrono::milliseconds( ms ) );
+}
+
+void delayMicroseconds( unsigned int us )
+{
+	std::this_thread::sleep_for( std::chrono::microseconds( us ) );
+}
+
+void yield( void )
+{
+	std::this_thread::yield();
+}
+
+void pinMode( uint8_t pin, uint8_t mode )
+{
+	if ( pin >= HOST_NUM_PINS )
+		return;
+
+	pin_mode[ pin ]	= mode;
+	
+	if ( mode == INPUT_PULLUP )
+		pin_level[ pin ]	= HIGH;
+}
+
+void digitalWrite( uint8_t pin, uint8_t val )
+{
+	if ( pin < HOST_NUM_PINS )
+		pin_level[ pin ]	= val ? HIGH : LOW;
+
+	if ( host_pin_output_hook )
+		host_pin_output_hook( pin, val ? HIGH : LOW );
+}
+
+int digitalRead( uint8_t pin )
+{
+	return ( pin < HOST_NUM_PINS ) ? pin_level[ pin ] : LOW;
+}
+
+int digitalPinToInterrupt( uint8_t pin )
+{
+	return ( pin < HOST_NUM_PINS ) ? pin : -1;
+}
+
+void attachInterrupt( int num, void (*isr)( void ), int mode )
+{
+	if ( (num < 0) || (HOST_NUM_PINS <= num) )
+		return;
+
+	noInterrupts();
+	isr_func[ num ]	= isr;
+	isr_mode[ num ]	= mode;
+	interrupts();
+}
+
+void detachInterrupt( int num )
+{
+	attachInterrupt( num, NULL, 0 );
+}
+
+void noInterrupts( void )
+{
+	if ( int_masked )
+		return;
+
+	int_lock.lock();
+	int_masked	= true;
+}
+
+static void call_isr( uint8_t pin );
+
+void interrupts( void )
+{
+	if ( !int_masked )
+		return;
+
+	int_masked	= false;
+	int_lock.unlock();
+
+	for ( int i = 0; i < HOST_NUM_PINS; i++ )
+	{
+		if ( int_pending[ i ] )
+		{
+			int_pending[ i ]	= false;
+			call_isr( i );
+		}
+	}
+}
+
+static void call_isr( uint8_t pin )
+{
+	if ( int_masked )
+	{
+		int_pending[ pin ]	= true;
+		return;
+	}
+
+	int_lock.lock();
+	int_masked	= true;
+
+	if ( isr_func[ pin ] )
+		(*isr_func[ pin ])();
+
+	int_masked	= false;
+	int_lock.unlock();
+}
+
+void host_pin_input( uint8_t pin, uint8_t val )
+{
+	if ( pin >= HOST_NUM_PINS )
+		return;
+
+	uint8_t	prev	= pin_level[ pin ];
+	
+	val	= val ? HIGH : LOW;
+	pin_level[ pin ]	= val;
+
+	if ( !isr_func[ pin ] || (prev == val) )
+		return;
+
+	if ( (isr_mode[ pin ] == CHANGE)
+		|| ((isr_mode[ pin ] == FALLING) && (val == LOW))
+		|| ((isr_mode[ pin ] == RISING)  && (val == HIGH)) )
+		call_isr( pin );
+}
+
+size_t Print::write( const uint8_t *buffer, size_t size )
+{
+	size_t	n	= 0;
+	
+	while ( size-- )
+		n	+= write( *buffer++ );
+
+	return n;
+}
+
+size_t Print::print_number( unsigned long n, int base )
+{
+	char	buf[ sizeof( unsigned long ) * 8 + 1 ];
+	char	*p	= buf + sizeof( buf ) - 1;
+
+	if ( base < 2 )
+		base	= 10;
+
+	*p	= '\0';
+
+	do {
+		int	d	= n % base;
+		*--p	= d < 10 ? '0' + d : 'A' + d - 10;
+		n	/= base;
+	} while ( n );
+
+	return write( p );
+}
+
+size_t Print::print( const char *s )					{ return write( s ); }
+size_t Print::print( char c )							{ return write( (uint8_t)c ); }
+size_t Print::print( int n, int base )					{ return print( (long)n, base ); }
+size_t Print::print( unsigned int n, int base )			{ return print_number( n, base ); }
+size_t Print::print( unsigned long n, int base )		{ return print_number( n, base ); }
+
+size_t Print::print( long n, int base )
+{
+	if ( (base == DEC) && (n < 0) )
+		return write( (uint8_t)'-' ) + print_number( -(unsigned long)n, DEC );
+
+	return print_number( (unsigned long)n, base );
+}
+
+size_t Print::print( double n, int digits )
+{
+	char	buf[ 64 ];
+
+	snprintf( buf, sizeof( buf ), "%.*f", digits, n );
+	return write( buf );
+}
+
+size_t Print::println( void )							{ return write( "\r\n" ); }
+size_t Print::println( const char *s )					{ return print( s ) + println(); }
+size_t Print::println( char c )							{ return print( c ) + println(); }
+size_t Print::println( int n, int base )				{ return print( n, base ) + println(); }
+size_t Print::println( unsigned int n, int base )		{ return print( n, base ) + println(); }
+size_t Print::println( long n, int base )				{ return print( n, base ) + println(); }
+size_t Print::println( unsigned long n, int base )		{ return print( n, base ) + println(); }
+size_t Print::println( double n, int digits )			{ return print( n, digits ) + println(); }
+
+void HardwareSerial::begin( unsigned long )
+{
+}
+
+size_t HardwareSerial::write( uint8_t c )
+{
+	return fwrite( &c, 1, 1, stdout );
+}
+
+size_t HardwareSerial::write( const uint8_t *buffer, size_t size )
+{
+	return fwrite( buffer, 1, size, stdout );
+}
+
+int HardwareSerial::available( void )	{ return 0; }
+int HardwareSerial::read( void )		{ return -1; }
+int HardwareSerial::peek( void )		{ return -1; }
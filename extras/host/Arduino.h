@@ -0,0 +1,155 @@
+/** Arduino API subset for Linux host build of RTC_NXP_Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef RTC_NXP_HOST_ARDUINO_H
+#define RTC_NXP_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#define	RTC_NXP_HOST	1
+
+#define HIGH			1
+#define LOW				0
+
+#define INPUT			0
+#define OUTPUT			1
+#define INPUT_PULLUP	2
+
+#define CHANGE			1
+#define FALLING			2
+#define RISING			3
+
+#define BIN				2
+#define OCT				8
+#define DEC				10
+#define HEX				16
+
+#define LSBFIRST		0
+#define MSBFIRST		1
+
+#define SS				10
+#define LED_BUILTIN		13
+
+#define PROGMEM
+#define pgm_read_byte( p )	(*(const uint8_t *)(p))
+#define F( s )				(s)
+
+typedef bool	boolean;
+typedef uint8_t	byte;
+
+/** Number of pins available on host */
+#define HOST_NUM_PINS	64
+
+unsigned long	millis( void );
+unsigned long	micros( void );
+void			delay( unsigned long ms );
+void			delayMicroseconds( unsigned int us );
+void			yield( void );
+
+void			pinMode( uint8_t pin, uint8_t mode );
+void			digitalWrite( uint8_t pin, uint8_t val );
+int				digitalRead( uint8_t pin );
+
+int				digitalPinToInterrupt( uint8_t pin );
+void			attachInterrupt( int num, void (*isr)( void ), int mode );
+void			detachInterrupt( int num );
+
+/** Interrupt masking
+ *
+ *	ISRs are called by host_pin_input() with a global lock held. 
+ *	noInterrupts() takes same lock so the ISR and the code in critical section are serialized. 
+ *	ISR triggered while masked in same thread is held pending until interrupts().
+ */
+void			noInterrupts( void );
+void			interrupts( void );
+
+/** Drive an input pin from host side (fake devices, GPIO monitor thread, etc.)
+ *
+ *	Calls attached ISR if the level change matches to its mode
+ *
+ * @param pin pin number
+ * @param val new level
+ */
+void			host_pin_input( uint8_t pin, uint8_t val );
+
+/** Hook called on digitalWrite() to emulate peripherals driven by output pins (e.g. SPI chip select)
+ *
+ *	Called after the pin level is updated
+ */
+extern void		(*host_pin_output_hook)( uint8_t pin, uint8_t val );
+
+class Print
+{
+public:
+	virtual ~Print() {}
+	virtual size_t write( uint8_t c )	= 0;
+	virtual size_t write( const uint8_t *buffer, size_t size );
+	size_t write( const char *s )	{ return write( (const uint8_t *)s, strlen( s ) ); }
+
+	size_t print( const char *s );
+	size_t print( char c );
+	size_t print( int n, int base = DEC );
+	size_t print( unsigned int n, int base = DEC );
+	size_t print( long n, int base = DEC );
+	size_t print( unsigned long n, int base = DEC );
+	size_t print( double n, int digits = 2 );
+
+	size_t println( void );
+	size_t println( const char *s );
+	size_t println( char c );
+	size_t println( int n, int base = DEC );
+	size_t println( unsigned int n, int base = DEC );
+	size_t println( long n, int base = DEC );
+	size_t println( unsigned long n, int base = DEC );
+	size_t println( double n, int digits = 2 );
+
+private:
+	size_t print_number( unsigned long n, int base );
+};
+
+class Stream : public Print
+{
+public:
+	virtual int available( void )	= 0;
+	virtual int read( void )		= 0;
+	virtual int peek( void )		= 0;
+};
+
+/** Serial on host: output to stdout, no input */
+class HardwareSerial : public Stream
+{
+public:
+	void	begin( unsigned long baud );
+	size_t	write( uint8_t c );
+	size_t	write( const uint8_t *buffer, size_t size );
+	int		available( void );
+	int		read( void );
+	int		peek( void );
+	operator bool()	{ return true; }
+};
+
+extern HardwareSerial	Serial;
+
+/** Print to a stdio FILE, for writing traces and logs into files */
+class FilePrint : public Print
+{
+public:
+	FilePrint( FILE *fp ) : file( fp ) {}
+	size_t	write( uint8_t c )	{ return fwrite( &c, 1, 1, file ); }
+	size_t	write( const uint8_t *buffer, size_t size )	{ return fwrite( buffer, 1, size, file ); }
+
+private:
+	FILE	*file;
+};
+
+#endif //	RTC_NXP_HOST_ARDUINO_H
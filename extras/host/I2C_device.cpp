@@ -0,0 +1,110 @@
+#include <I2C_device.h>
+
+I2C_device::I2C_device( uint8_t i2c_address ) : wire( Wire ), i2c_addr( i2c_address )
+{
+}
+
+I2C_device::I2C_device( TwoWire& wire, uint8_t i2c_address ) : wire( wire ), i2c_addr( i2c_address )
+{
+}
+
+I2C_device::~I2C_device()
+{
+}
+
+int I2C_device::tx( uint8_t *data, uint16_t size, bool stop )
+{
+	wire.beginTransmission( i2c_addr );
+	wire.write( data, size );
+	
+	return wire.endTransmission( stop ) ? -1 : size;
+}
+
+int I2C_device::rx( uint8_t *data, uint16_t size )
+{
+	int	n	= wire.requestFrom( i2c_addr, (uint8_t)size );
+
+	for ( int i = 0; i < n; i++ )
+		data[ i ]	= wire.read();
+
+	return n;
+}
+
+int I2C_device::reg_w( uint8_t reg_adr, uint8_t *data, uint16_t size )
+{
+	wire.beginTransmission( i2c_addr );
+	wire.write( reg_adr );
+	wire.write( data, size );
+
+	return wire.endTransmission() ? -1 : size;
+}
+
+int I2C_device::reg_w( uint8_t reg_adr, uint8_t data )
+{
+	return reg_w( reg_adr, &data, 1 );
+}
+
+int I2C_device::reg_r( uint8_t reg_adr, uint8_t *data, uint16_t size )
+{
+	wire.beginTransmission( i2c_addr );
+	wire.write( reg_adr );
+	wire.endTransmission( false );
+
+	int	n	= rx( data, size );
+
+	if ( n < size )
+		memset( data + n, 0xFF, size - n );
+
+	return n;
+}
+
+uint8_t I2C_device::reg_r( uint8_t reg_adr )
+{
+	uint8_t	data;
+	
+	reg_r( reg_adr, &data, 1 );
+	return data;
+}
+
+void I2C_device::write_r8( uint8_t reg, uint8_t val )
+{
+	reg_w( reg, val );
+}
+
+void I2C_device::write_r16( uint8_t reg, uint16_t val )
+{
+	uint8_t	v[]	= { (uint8_t)(val >> 8), (uint8_t)val };
+
+	reg_w( reg, v, sizeof( v ) );
+}
+
+uint8_t I2C_device::read_r8( uint8_t reg )
+{
+	return reg_r( reg );
+}
+
+uint16_t I2C_device::read_r16( uint8_t reg )
+{
+	uint8_t	v[ 2 ];
+
+	reg_r( reg, v, sizeof( v ) );
+	return (v[ 0 ] << 8) | v[ 1 ];
+}
+
+void I2C_device::bit_op8( uint8_t reg, uint8_t mask, uint8_t value )
+{
+	uint8_t	tmp	= reg_r( reg ) & mask;
+	reg_w( reg, tmp | value );
+}
+
+void I2C_device::bit_op16( uint8_t reg, uint16_t mask, uint16_t value )
+{
+	uint16_t	tmp	= read_r16( reg ) & mask;
+	write_r16( reg, tmp | value );
+}
+
+bool I2C_device::ping( void )
+{
+	wire.beginTransmission( i2c_addr );
+	return wire.endTransmission() == 0;
+}
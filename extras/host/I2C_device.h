@@ -0,0 +1,43 @@
+/** I2C_device for Linux host build of RTC_NXP_Arduino
+ *
+ *	Same interface as I2C_device class in I2C_device_Arduino library, 
+ *	working on host TwoWire
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef RTC_NXP_HOST_I2C_DEVICE_H
+#define RTC_NXP_HOST_I2C_DEVICE_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+class I2C_device
+{
+public:
+	I2C_device( uint8_t i2c_address );
+	I2C_device( TwoWire& wire, uint8_t i2c_address );
+	virtual ~I2C_device();
+
+	int		tx( uint8_t *data, uint16_t size, bool stop = true );
+	int		rx( uint8_t *data, uint16_t size );
+	int		reg_w( uint8_t reg_adr, uint8_t *data, uint16_t size );
+	int		reg_w( uint8_t reg_adr, uint8_t data );
+	int		reg_r( uint8_t reg_adr, uint8_t *data, uint16_t size );
+	uint8_t	reg_r( uint8_t reg_adr );
+	void	write_r8( uint8_t reg, uint8_t val );
+	void	write_r16( uint8_t reg, uint16_t val );
+	uint8_t	read_r8( uint8_t reg );
+	uint16_t	read_r16( uint8_t reg );
+	void	bit_op8( uint8_t reg, uint8_t mask, uint8_t value );
+	void	bit_op16( uint8_t reg, uint16_t mask, uint16_t value );
+	bool	ping( void );
+
+protected:
+	TwoWire&	wire;
+	uint8_t		i2c_addr;
+};
+
+#endif //	RTC_NXP_HOST_I2C_DEVICE_H
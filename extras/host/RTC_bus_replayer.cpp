@@ -0,0 +1,299 @@
+#include <RTC_bus_replayer.h>
+
+RTC_trace_reader::RTC_trace_reader() : file( NULL ), own_file( false ), error_message( NULL ), time_us( 0 ), records( 0 )
+{
+}
+
+RTC_trace_reader::~RTC_trace_reader()
+{
+	close();
+}
+
+bool RTC_trace_reader::open( const char *path )
+{
+	close();
+	
+	if ( !strcmp( path, "-" ) )
+		return open( stdin );
+	
+	FILE	*fp	= fopen( path, "rb" );
+	
+	if ( !fp )
+	{
+		error_message	= "cannot open file";
+		return false;
+	}
+
+	if ( !open( fp ) )
+		return false;
+
+	own_file	= true;
+	return true;
+}
+
+bool RTC_trace_reader::open( FILE *fp )
+{
+	uint8_t	h[ 5 ];
+
+	close();
+
+	file			= fp;
+	error_message	= NULL;
+	time_us			= 0;
+	records			= 0;
+	
+	if ( !get( h, sizeof( h ) ) || memcmp( h, "RTCT", 4 ) )
+	{
+		error_message	= "not a RTC_NXP bus trace";
+		return false;
+	}
+	
+	if ( (h[ 4 ] < 1) || (RTC_bus_recorder::version < h[ 4 ]) )
+	{
+		error_message	= "unsupported trace version";
+		return false;
+	}
+
+	return true;
+}
+
+void RTC_trace_reader::close( void )
+{
+	if ( file && own_file )
+		fclose( file );
+
+	file		= NULL;
+	own_file	= false;
+}
+
+bool RTC_trace_reader::get( uint8_t *p, int n )
+{
+	return file && ((int)fread( p, 1, n, file ) == n);
+}
+
+bool RTC_trace_reader::next( RTC_trace_record& r )
+{
+	uint8_t	v[ 3 ];
+	int		shift	= 0;
+	
+	if ( error_message || !get( &r.type, 1 ) )
+		return false;
+
+	r.delta_us	= 0;
+
+	do {
+		if ( !get( v, 1 ) || (shift > 28) )
+		{
+			error_message	= "broken time field";
+			return false;
+		}
+		r.delta_us	|= (uint32_t)(v[ 0 ] & 0x7F) << shift;
+		shift		+= 7;
+	} while ( v[ 0 ] & 0x80 );
+
+	time_us		+= r.delta_us;
+	r.time_us	= time_us;
+	r.dev		= 0;
+	r.reg		= 0;
+	r.size		= 0;
+	
+	switch ( r.type )
+	{
+		case RTC_bus_recorder::REG_WRITE :
+		case RTC_bus_recorder::REG_READ :
+			if ( !get( v, 3 ) )
+				break;
+			r.dev	= v[ 0 ];
+			r.reg	= v[ 1 ];
+			r.size	= v[ 2 ];
+			if ( !get( r.data, r.size ) )
+				break;
+			records++;
+			return true;
+
+		case RTC_bus_recorder::SPI_TRANSFER :
+			if ( !get( &r.size, 1 ) || !get( r.data, r.size ) || !get( r.rx, r.size ) )
+				break;
+			records++;
+			return true;
+
+		case RTC_bus_recorder::MARKER :
+			if ( !get( &r.reg, 1 ) )
+				break;
+			records++;
+			return true;
+
+		case RTC_bus_recorder::ACCESS_ERROR :
+			if ( !get( v, 3 ) || !get( &r.status, 1 ) )
+				break;
+			r.dev		= v[ 0 ];
+			r.reg		= v[ 1 ];
+			r.access	= v[ 2 ];
+			records++;
+			return true;
+
+		default :
+			error_message	= "unknown record type";
+			return false;
+	}
+
+	error_message	= "truncated record";
+	return false;
+}
+
+const char *RTC_trace_reader::error( void )
+{
+	return error_message;
+}
+
+unsigned long RTC_trace_reader::count( void )
+{
+	return records;
+}
+
+RTC_bus_replayer::RTC_bus_replayer( RTC_trace_reader& reader, int options )
+	: trace( reader ), opt( options ), has_rec( false ), n_access( 0 ), n_mismatch( 0 ), n_overrun( 0 ), last_us( 0 )
+{
+}
+
+RTC_bus_replayer::~RTC_bus_replayer()
+{
+}
+
+bool RTC_bus_replayer::next_access( void )
+{
+	while ( trace.next( rec ) )
+		if ( rec.type != RTC_bus_recorder::MARKER )
+			return true;
+
+	return false;
+}
+
+bool RTC_bus_replayer::fetch( void )
+{
+	if ( !has_rec && !next_access() )
+	{
+		n_overrun++;
+		return false;
+	}
+
+	has_rec	= false;
+
+	if ( opt & PACE )
+	{
+		if ( n_access )
+			while ( (micros() - last_us) < rec.delta_us )
+				delayMicroseconds( rec.delta_us - (micros() - last_us) );
+
+		last_us	= micros();
+	}
+
+	n_access++;
+	return true;
+}
+
+void RTC_bus_replayer::mismatch( const char *what )
+{
+	n_mismatch++;
+
+	if ( opt & VERBOSE )
+		fprintf( stderr, "replay mismatch at record %lu (%.6f s): %s\n", trace.count(), rec.time_us / 1e6, what );
+}
+
+int RTC_bus_replayer::i2c_transfer( uint8_t addr, const uint8_t *wp, int wn, uint8_t *rp, int rn )
+{
+	if ( !wn && !rn )
+		return 0;	//	ping
+
+	if ( !fetch() )
+	{
+		memset( rp, 0xFF, rn );
+		return 0;
+	}
+
+	uint8_t	type	= rn ? RTC_bus_recorder::REG_READ : RTC_bus_recorder::REG_WRITE;
+	uint8_t	reg		= wn ? wp[ 0 ] : 0;
+	int		size	= rn ? rn : wn - 1;
+
+	bool	failed	= (rec.type == RTC_bus_recorder::ACCESS_ERROR);
+
+	if ( (failed ? rec.access : rec.type) != type )
+		mismatch( rn ? "read expected write" : "write expected read" );
+	else if ( rec.dev != addr )
+		mismatch( "device address" );
+	else if ( rec.reg != reg )
+		mismatch( "register" );
+	else if ( failed )
+		;	//	size and data are not recorded for failed access
+	else if ( rec.size != size )
+		mismatch( "size" );
+	else if ( !rn && memcmp( rec.data, wp + 1, size ) )
+		mismatch( "written data" );
+
+	if ( rn )
+	{
+		memset( rp, 0xFF, rn );
+		
+		if ( rec.type == RTC_bus_recorder::REG_READ )
+			memcpy( rp, rec.data, rn < rec.size ? rn : rec.size );
+	}
+
+	if ( failed )
+		return (rec.status <= 4) ? rec.status : 4;
+
+	return 0;
+}
+
+void RTC_bus_replayer::spi_transfer( uint8_t *data, int size )
+{
+	if ( !fetch() )
+	{
+		memset( data, 0xFF, size );
+		return;
+	}
+
+	if ( rec.type != RTC_bus_recorder::SPI_TRANSFER )
+		mismatch( "SPI transfer expected register access" );
+	else if ( rec.size != size )
+		mismatch( "size" );
+	else if ( memcmp( rec.data, data, size ) )
+		mismatch( "sent data" );
+
+	memset( data, 0xFF, size );
+	
+	if ( rec.type == RTC_bus_recorder::SPI_TRANSFER )
+		memcpy( data, rec.rx, size < rec.size ? size : rec.size );
+}
+
+unsigned long RTC_bus_replayer::accesses( void )
+{
+	return n_access;
+}
+
+unsigned long RTC_bus_replayer::mismatches( void )
+{
+	return n_mismatch;
+}
+
+unsigned long RTC_bus_replayer::overruns( void )
+{
+	return n_overrun;
+}
+
+bool RTC_bus_replayer::finished( void )
+{
+	if ( !has_rec )
+		has_rec	= next_access();
+
+	return !has_rec;
+}
+
+void RTC_bus_replayer::report( FILE *fp )
+{
+	fprintf( fp, "replayed %lu accesses, %lu mismatches, %lu accesses after end of trace", n_access, n_mismatch, n_overrun );
+
+	if ( trace.error() )
+		fprintf( fp, ", trace error: %s", trace.error() );
+
+	fprintf( fp, "\n" );
+}
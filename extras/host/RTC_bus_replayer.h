@@ -0,0 +1,157 @@
+/** Bus trace reader and replayer for Linux host build of RTC_NXP_Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef RTC_NXP_HOST_RTC_BUS_REPLAYER_H
+#define RTC_NXP_HOST_RTC_BUS_REPLAYER_H
+
+#include <RTC_NXP.h>
+#include <host_bus.h>
+
+/** One record in the trace made by RTC_bus_recorder */
+struct RTC_trace_record {
+	uint8_t		type;			//	RTC_bus_recorder::record_type
+	uint32_t	delta_us;		//	time from previous record
+	uint64_t	time_us;		//	time from start of the trace
+	uint8_t		dev;			//	device address (register access)
+	uint8_t		reg;			//	register (register access) or marker ID
+	uint8_t		size;			//	data size
+	uint8_t		data[ 256 ];	//	written/read data or SPI tx data
+	uint8_t		rx[ 256 ];		//	SPI rx data
+	uint8_t		access;			//	access type of access error record: REG_WRITE or REG_READ
+	uint8_t		status;			//	bus status of access error record
+};
+
+/** RTC_trace_reader class
+ *	
+ *	Reads trace record by record from a file or stream
+ *
+ *  @class RTC_trace_reader
+ */
+
+class RTC_trace_reader
+{
+public:
+	RTC_trace_reader();
+	virtual ~RTC_trace_reader();
+
+	/** Open trace file
+	 *
+	 * @param path file path ("-" for stdin)
+	 * @return true if the header is valid
+	 */
+	bool open( const char *path );
+
+	/** Start reading from opened stream
+	 *
+	 * @param fp stream (not closed by this class)
+	 * @return true if the header is valid
+	 */
+	bool open( FILE *fp );
+
+	/** Close trace file */
+	void close( void );
+
+	/** Read next record
+	 *
+	 * @param r record to be filled
+	 * @return false at end of trace or on format error
+	 */
+	bool next( RTC_trace_record& r );
+
+	/** Format error
+	 *
+	 * @return error message or NULL if no error
+	 */
+	const char *error( void );
+
+	/** Number of records read */
+	unsigned long count( void );
+
+private:
+	bool get( uint8_t *p, int n );
+
+	FILE		*file;
+	bool		own_file;
+	const char	*error_message;
+	uint64_t	time_us;
+	unsigned long	records;
+};
+
+/** RTC_bus_replayer class
+ *	
+ *	Bus backend driven by a trace. 
+ *	Register reads and SPI transfers return data in the trace, so that the library works as it did in the captured session. 
+ *	Register writes are compared with the trace and the differences are reported as mismatches. 
+ *	Accesses recorded as failed return the recorded error status. 
+ *	On mismatch, the record is consumed anyway to keep replay in step. 
+ *	Marker records are skipped. 
+ *
+ *	Usage:
+ *	  RTC_trace_reader	trace;
+ *	  trace.open( "capture.bin" );
+ *	  RTC_bus_replayer	replayer( trace );
+ *	  Wire.bus( &replayer );	//	and/or SPI.bus( &replayer )
+ *	  //	run the code which made the trace
+ *	  replayer.report( stdout );
+ *
+ *  @class RTC_bus_replayer
+ */
+
+class RTC_bus_replayer : public host_i2c_bus, public host_spi_bus
+{
+public:
+	/** Replay options */
+	enum option {
+		VERBOSE	= 0x01,	//	report each mismatch to stderr
+		PACE	= 0x02,	//	keep time intervals of the trace by waiting
+	};
+
+	/** Create a RTC_bus_replayer instance
+	 *
+	 * @param reader opened trace
+	 * @param options option flags
+	 */
+	RTC_bus_replayer( RTC_trace_reader& reader, int options = VERBOSE );
+	virtual ~RTC_bus_replayer();
+
+	int		i2c_transfer( uint8_t addr, const uint8_t *wp, int wn, uint8_t *rp, int rn );
+	void	spi_transfer( uint8_t *data, int size );
+
+	/** Number of accesses replayed */
+	unsigned long accesses( void );
+
+	/** Number of mismatches found */
+	unsigned long mismatches( void );
+
+	/** Number of accesses after the trace ended */
+	unsigned long overruns( void );
+
+	/** All records in the trace were replayed */
+	bool finished( void );
+
+	/** Print summary
+	 *
+	 * @param fp output stream
+	 */
+	void report( FILE *fp );
+
+private:
+	bool	next_access( void );
+	bool	fetch( void );
+	void	mismatch( const char *what );
+
+	RTC_trace_reader&	trace;
+	RTC_trace_record	rec;
+	int					opt;
+	bool				has_rec;
+	unsigned long		n_access;
+	unsigned long		n_mismatch;
+	unsigned long		n_overrun;
+	unsigned long		last_us;
+};
+
+#endif //	RTC_NXP_HOST_RTC_BUS_REPLAYER_H
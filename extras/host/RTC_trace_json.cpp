@@ -0,0 +1,66 @@
+#include <RTC_trace_json.h>
+
+#include <unistd.h>
+#include <sys/syscall.h>
+
+RTC_trace_json::RTC_trace_json( FILE *fp ) : out( fp ), n_events( 0 )
+{
+	if ( out )
+		fprintf( out, "{\"traceEvents\":[\n" );
+}
+
+RTC_trace_json::~RTC_trace_json()
+{
+	close();
+}
+
+void RTC_trace_json::enter( const char* name, const void* dev )
+{
+	put( 'B', name, dev, "" );
+}
+
+void RTC_trace_json::exit( const char* name, const void* dev )
+{
+	put( 'E', name, dev, "" );
+}
+
+void RTC_trace_json::event( const char* name, const void* dev, uint32_t value )
+{
+	char	extra[ 32 ];
+
+	snprintf( extra, sizeof( extra ), ",\"value\":%lu", (unsigned long)value );
+	put( 'i', name, dev, extra );
+}
+
+void RTC_trace_json::put( char ph, const char* name, const void* dev, const char* extra )
+{
+	unsigned long	ts	= micros();
+	long			tid	= syscall( SYS_gettid );
+
+	std::lock_guard<std::mutex>	lock( mtx );
+
+	if ( !out )
+		return;
+
+	fprintf( out, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%lu,\"pid\":%d,\"tid\":%ld,%s\"args\":{\"dev\":\"%p\"%s}}",
+		n_events ? ",\n" : "", name, ph, ts, (int)getpid(), tid, (ph == 'i') ? "\"s\":\"t\"," : "", dev, extra );
+
+	n_events++;
+}
+
+void RTC_trace_json::close( void )
+{
+	std::lock_guard<std::mutex>	lock( mtx );
+
+	if ( !out )
+		return;
+
+	fprintf( out, "\n]}\n" );
+	fclose( out );
+	out	= NULL;
+}
+
+unsigned long RTC_trace_json::events( void )
+{
+	return n_events;
+}
@@ -0,0 +1,60 @@
+/** chrome://tracing sink for host build of RTC_NXP_Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef RTC_NXP_HOST_RTC_TRACE_JSON_H
+#define RTC_NXP_HOST_RTC_TRACE_JSON_H
+
+#include <RTC_NXP.h>
+#include <stdio.h>
+#include <mutex>
+
+/** RTC_trace_json class
+ *	
+ *	Writes driver method enter/exit and events in Trace Event Format. 
+ *	The output can be loaded into chrome://tracing or https://ui.perfetto.dev. 
+ *	Time stamps are micros(). Each calling thread is shown as a track. 
+ *	Instance address and event value are given as "args". 
+ *
+ *	Usage:
+ *	  RTC_trace_json	trace( fopen( "rtc.json", "w" ) );
+ *	  RTC_trace::sink( &trace );
+ *	  ...
+ *	  RTC_trace::sink( nullptr );
+ *	  trace.close();
+ *
+ *  @class RTC_trace_json
+ */
+
+class RTC_trace_json : public RTC_trace
+{
+public:
+	/** Create a RTC_trace_json instance
+	 *
+	 * @param fp output stream (closed by close() or destructor)
+	 */
+	RTC_trace_json( FILE *fp );
+	virtual ~RTC_trace_json();
+
+	void enter( const char* name, const void* dev );
+	void exit( const char* name, const void* dev );
+	void event( const char* name, const void* dev, uint32_t value );
+
+	/** Terminate JSON and close the stream */
+	void close( void );
+
+	/** Number of events written */
+	unsigned long events( void );
+
+private:
+	void	put( char ph, const char* name, const void* dev, const char* extra );
+
+	FILE			*out;
+	unsigned long	n_events;
+	std::mutex		mtx;
+};
+
+#endif //	RTC_NXP_HOST_RTC_TRACE_JSON_H
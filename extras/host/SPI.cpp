@@ -0,0 +1,102 @@
+#include <SPI.h>
+
+SPIClass	SPI;
+
+static void ss_hook( uint8_t pin, uint8_t val )
+{
+	if ( pin == SS )
+		SPI.chip_select( val == LOW );
+}
+
+SPIClass::SPIClass() : backend( NULL ), selected( false ), n_seg( 0 )
+{
+	host_pin_output_hook	= ss_hook;
+}
+
+void SPIClass::bus( host_spi_bus *bus )
+{
+	backend	= bus;
+}
+
+host_spi_bus *SPIClass::bus( void )
+{
+	return backend;
+}
+
+void SPIClass::begin( void )
+{
+}
+
+void SPIClass::end( void )
+{
+}
+
+void SPIClass::beginTransaction( SPISettings settings )
+{
+	current	= settings;
+}
+
+void SPIClass::endTransaction( void )
+{
+}
+
+SPISettings SPIClass::settings( void )
+{
+	return current;
+}
+
+uint8_t SPIClass::transfer( uint8_t data )
+{
+	transferBytes( &data, &data, 1 );
+	
+	if ( selected )
+		flush();
+
+	return data;
+}
+
+void SPIClass::transfer( void *buf, size_t count )
+{
+	transferBytes( (uint8_t *)buf, (uint8_t *)buf, count );
+}
+
+void SPIClass::transferBytes( const uint8_t *data, uint8_t *out, uint32_t size )
+{
+	if ( n_seg == max_segments )
+		flush();
+
+	seg[ n_seg ].tx		= data;
+	seg[ n_seg ].rx		= out;
+	seg[ n_seg ].size	= size;
+	n_seg++;
+
+	if ( !selected )
+		flush();
+}
+
+void SPIClass::chip_select( bool active )
+{
+	if ( selected && !active )
+		flush();
+
+	selected	= active;
+}
+
+void SPIClass::flush( void )
+{
+	if ( !n_seg )
+		return;
+
+	if ( backend )
+	{
+		backend->spi_message( seg, n_seg );
+	}
+	else
+	{
+		for ( int i = 0; i < n_seg; i++ )
+			if ( seg[ i ].rx )
+				memset( seg[ i ].rx, 0xFF, seg[ i ].size );
+	}
+
+	n_seg	= 0;
+}
@@ -0,0 +1,96 @@
+/** SPIClass for Linux host build of RTC_NXP_Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef RTC_NXP_HOST_SPI_H
+#define RTC_NXP_HOST_SPI_H
+
+#include <Arduino.h>
+#include <host_bus.h>
+
+#define SPI_MODE0	0x00
+#define SPI_MODE1	0x01
+#define SPI_MODE2	0x02
+#define SPI_MODE3	0x03
+
+class SPISettings
+{
+public:
+	SPISettings() : clock( 4000000 ), bitOrder( MSBFIRST ), dataMode( SPI_MODE0 ) {}
+	SPISettings( uint32_t clock, uint8_t bitOrder, uint8_t dataMode ) : clock( clock ), bitOrder( bitOrder ), dataMode( dataMode ) {}
+
+	uint32_t	clock;
+	uint8_t		bitOrder;
+	uint8_t		dataMode;
+};
+
+/** SPIClass class on host
+ *	
+ *	Transfers are done by a host_spi_bus backend. 
+ *	While SS pin is LOW, transfers are collected as segments of a message and 
+ *	the message is sent to the backend when SS goes HIGH. 
+ *	So the received data is available after SS is deasserted. 
+ *
+ *  @class SPIClass
+ */
+
+class SPIClass
+{
+public:
+	SPIClass();
+
+	/** Set backend
+	 *
+	 * @param bus backend to be used. With nullptr, all received data are 0xFF
+	 */
+	void	bus( host_spi_bus *bus );
+
+	/** Get backend */
+	host_spi_bus	*bus( void );
+
+	void	begin( void );
+	void	end( void );
+	void	beginTransaction( SPISettings settings );
+	void	endTransaction( void );
+	SPISettings	settings( void );
+
+	/** Single byte transfer
+	 *
+	 *	Received data is needed immediately, so collected segments and this byte are sent as a message
+	 */
+	uint8_t	transfer( uint8_t data );
+	void	transfer( void *buf, size_t count );
+
+	/** Transfer with separate send and receive buffers (compatible to ESP32 core)
+	 *
+	 * @param data data to be sent. 0xFF is sent if NULL
+	 * @param out buffer for received data. Discarded if NULL
+	 * @param size data size
+	 */
+	void	transferBytes( const uint8_t *data, uint8_t *out, uint32_t size );
+
+	/** Chip select change, called on SS pin change
+	 *
+	 * @param active true when SS is LOW
+	 */
+	void	chip_select( bool active );
+
+	/** Maximum number of segments in a message */
+	static const int	max_segments	= 8;
+
+private:
+	void			flush( void );
+
+	host_spi_bus		*backend;
+	SPISettings			current;
+	bool				selected;
+	host_spi_segment	seg[ max_segments ];
+	int					n_seg;
+};
+
+extern SPIClass	SPI;
+
+#endif //	RTC_NXP_HOST_SPI_H
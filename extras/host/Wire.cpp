@@ -0,0 +1,130 @@
+#include <Wire.h>
+
+TwoWire	Wire;
+
+TwoWire::TwoWire() : backend( NULL ), clock( 100000 ), timeout_us( 0 ), timeout_flag( false ), tx_addr( 0 ), tx_len( 0 ), tx_pending( false ), rx_len( 0 ), rx_idx( 0 )
+{
+}
+
+void TwoWire::bus( host_i2c_bus *bus )
+{
+	backend	= bus;
+}
+
+host_i2c_bus *TwoWire::bus( void )
+{
+	return backend;
+}
+
+void TwoWire::begin( void )
+{
+}
+
+void TwoWire::end( void )
+{
+}
+
+void TwoWire::setClock( uint32_t freq )
+{
+	clock	= freq;
+}
+
+uint32_t TwoWire::getClock( void )
+{
+	return clock;
+}
+
+void TwoWire::setWireTimeout( uint32_t timeout, bool )
+{
+	timeout_us	= timeout;
+}
+
+bool TwoWire::getWireTimeoutFlag( void )
+{
+	return timeout_flag;
+}
+
+void TwoWire::clearWireTimeoutFlag( void )
+{
+	timeout_flag	= false;
+}
+
+void TwoWire::beginTransmission( uint8_t address )
+{
+	tx_addr		= address;
+	tx_len		= 0;
+	tx_pending	= false;
+}
+
+uint8_t TwoWire::endTransmission( bool stop )
+{
+	if ( !stop )
+	{
+		tx_pending	= true;
+		return 0;
+	}
+
+	if ( !backend )
+		return 2;
+
+	return backend->i2c_transfer( tx_addr, tx_buf, tx_len, NULL, 0 );
+}
+
+uint8_t TwoWire::requestFrom( uint8_t address, uint8_t quantity, uint8_t )
+{
+	const uint8_t	*wp	= NULL;
+	int				wn	= 0;
+
+	if ( tx_pending && (tx_addr == address) )
+	{
+		wp	= tx_buf;
+		wn	= tx_len;
+	}
+
+	tx_pending	= false;
+	rx_len		= 0;
+	rx_idx		= 0;
+
+	if ( quantity > WIRE_BUFFER_LENGTH )	//	same as AVR core
+		quantity	= (uint8_t)WIRE_BUFFER_LENGTH;
+
+	if ( !backend || backend->i2c_transfer( address, wp, wn, rx_buf, quantity ) )
+		return 0;
+
+	rx_len	= quantity;
+	return quantity;
+}
+
+size_t TwoWire::write( uint8_t data )
+{
+	if ( tx_len >= WIRE_BUFFER_LENGTH )
+		return 0;
+
+	tx_buf[ tx_len++ ]	= data;
+	return 1;
+}
+
+size_t TwoWire::write( const uint8_t *data, size_t size )
+{
+	size_t	n	= 0;
+
+	while ( size-- && write( *data++ ) )
+		n++;
+
+	return n;
+}
+
+int TwoWire::available( void )
+{
+	return rx_len - rx_idx;
+}
+
+int TwoWire::read( void )
+{
+	return ( rx_idx < rx_len ) ? rx_buf[ rx_idx++ ] : -1;
+}
+
+int TwoWire::peek( void )
+{
+	return ( rx_idx < rx_len ) ? rx_buf[ rx_idx ] : -1;
+}
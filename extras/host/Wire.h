@@ -0,0 +1,77 @@
+/** TwoWire for Linux host build of RTC_NXP_Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef RTC_NXP_HOST_WIRE_H
+#define RTC_NXP_HOST_WIRE_H
+
+#include <Arduino.h>
+#include <host_bus.h>
+
+//	buffer size can be given in compiler flags, e.g. -DWIRE_BUFFER_LENGTH=32 to test as AVR
+#ifndef WIRE_BUFFER_LENGTH
+#define WIRE_BUFFER_LENGTH	256
+#endif
+#define WIRE_HAS_TIMEOUT	1
+
+/** TwoWire class on host
+ *	
+ *	Transfers are done by a host_i2c_bus backend. 
+ *	endTransmission( false ) holds the written data and following requestFrom() 
+ *	issues it with the read as one combined transfer. 
+ *
+ *  @class TwoWire
+ */
+
+class TwoWire : public Stream
+{
+public:
+	TwoWire();
+
+	/** Set backend
+	 *
+	 * @param bus backend to be used. nullptr makes all transfers NACKed
+	 */
+	void	bus( host_i2c_bus *bus );
+
+	/** Get backend */
+	host_i2c_bus	*bus( void );
+
+	void	begin( void );
+	void	end( void );
+	void	setClock( uint32_t freq );
+	uint32_t	getClock( void );
+	void	setWireTimeout( uint32_t timeout = 25000, bool reset_with_timeout = false );
+	bool	getWireTimeoutFlag( void );
+	void	clearWireTimeoutFlag( void );
+
+	void	beginTransmission( uint8_t address );
+	uint8_t	endTransmission( bool stop = true );
+	uint8_t	requestFrom( uint8_t address, uint8_t quantity, uint8_t stop = true );
+
+	size_t	write( uint8_t data );
+	size_t	write( const uint8_t *data, size_t size );
+	int		available( void );
+	int		read( void );
+	int		peek( void );
+
+private:
+	host_i2c_bus	*backend;
+	uint32_t		clock;
+	uint32_t		timeout_us;
+	bool			timeout_flag;
+	uint8_t			tx_addr;
+	uint8_t			tx_buf[ WIRE_BUFFER_LENGTH ];
+	int				tx_len;
+	bool			tx_pending;
+	uint8_t			rx_buf[ WIRE_BUFFER_LENGTH ];
+	int				rx_len;
+	int				rx_idx;
+};
+
+extern TwoWire	Wire;
+
+#endif //	RTC_NXP_HOST_WIRE_H
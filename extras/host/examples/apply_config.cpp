@@ -0,0 +1,154 @@
+/** apply_config: declarative configuration of PCF2131
+ *
+ *	Same configuration is made by individual method calls and by apply().
+ *	apply() reads the configuration registers once and writes only changed registers.
+ *	Both ways must give same register image from the reset state.
+ *	Number of bus transfers is shown for each.
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <RTC_NXP.h>
+
+class counting_bus : public fake_register_bus
+{
+public:
+	counting_bus() : count( 0 ) {}
+
+	int i2c_transfer( uint8_t addr, const uint8_t *wp, int wn, uint8_t *rp, int rn )
+	{
+		count++;
+		return fake_register_bus::i2c_transfer( addr, wp, wn, rp, rn );
+	}
+
+	int	count;
+};
+
+static counting_bus	bus;
+
+static int check( const char* name, int value, int expected )
+{
+	printf( "%-40s : %2d%s\n", name, value, (value == expected) ? "" : "  *** unexpected ***" );
+
+	return (value == expected) ? 0 : 1;
+}
+
+static int check_reg( const char* name, uint8_t value, uint8_t expected )
+{
+	printf( "  %-38s : %02X%s\n", name, value, (value == expected) ? "" : "  *** unexpected ***" );
+
+	return (value == expected) ? 0 : 1;
+}
+
+//	reset values of the registers which are not 0
+
+static void reset( uint8_t *regs )
+{
+	memset( regs, 0, 256 );
+	regs[ PCF2131_base::INT_A_MASK1 ]		= 0x3F;	//	all interrupts masked
+	regs[ PCF2131_base::INT_A_MASK2 ]		= 0x0F;
+	regs[ PCF2131_base::INT_B_MASK1 ]		= 0x3F;
+	regs[ PCF2131_base::INT_B_MASK2 ]		= 0x0F;
+	regs[ PCF2131_base::Watchdg_tim_ctl ]	= 0x03;
+	regs[ PCF2131_base::Aging_offset ]		= 0x08;
+}
+
+//	configuration registers handled by apply(): Control_1..Control_5 and CLKOUT_ctl..Watchdg_tim_val
+
+static int compare( const uint8_t *image, const uint8_t *regs )
+{
+	int	diff	= 0;
+
+	for ( int r = PCF2131_base::Control_1; r <= PCF2131_base::Watchdg_tim_val; r++ )
+	{
+		if ( (PCF2131_base::Control_5 < r) && (r < PCF2131_base::CLKOUT_ctl) )
+			continue;
+
+		if ( image[ r ] != regs[ r ] )
+		{
+			printf( "  register 0x%02X: individual calls %02X, apply() %02X  *** unexpected ***\n", r, image[ r ], regs[ r ] );
+			diff++;
+		}
+	}
+
+	return diff;
+}
+
+int main( void )
+{
+	PCF2131_I2C	rtc;
+	uint8_t		*regs	= bus.regs( 0xA6 >> 1 );
+	int			fail	= 0;
+	int			bursts;
+	uint8_t		image[ 256 ];
+
+	//	Control_1..Control_5, then CLKOUT_ctl..Watchdg_tim_val (36 bytes) split to fit in the I2C buffer
+	const int	size	= PCF2131_base::Watchdg_tim_val - PCF2131_base::CLKOUT_ctl + 1;
+	const int	reads	= 1 + (size + RTC_NXP_I2C_BUFFER - 2) / (RTC_NXP_I2C_BUFFER - 1);
+
+	bus.enable( 0xA6 >> 1 );
+	Wire.bus( &bus );
+
+	//	individual calls
+
+	reset( regs );
+
+	bus.count	= 0;
+	rtc.periodic_interrupt_enable( PCF2131_base::EVERY_SECOND, 0 );
+	rtc.timestamp( 1, PCF2131_base::FIRST, 1 );
+	rtc.timestamp( 2, PCF2131_base::FIRST, 1 );
+	rtc.set_clock_out( RTC_NXP::FREQ_1_HZ );
+	printf( "%-40s : %2d\n", "individual calls: transfers", bus.count );
+
+	memcpy( image, regs, sizeof( image ) );
+
+	//	same as above by apply()
+
+	PCF2131_base::config	cfg;
+
+	cfg.periodic		= PCF2131_base::EVERY_SECOND;
+	cfg.periodic_int	= PCF2131_base::ROUTE_INT_A;
+	cfg.ts_int[ 0 ]		= PCF2131_base::ROUTE_INT_B;
+	cfg.ts_int[ 1 ]		= PCF2131_base::ROUTE_INT_B;
+	cfg.ts_mode[ 0 ]	= PCF2131_base::FIRST;
+	cfg.ts_mode[ 1 ]	= PCF2131_base::FIRST;
+	cfg.clock_out		= RTC_NXP::FREQ_1_HZ;
+
+	reset( regs );
+
+	bus.count	= 0;
+	bursts		= rtc.apply( cfg );
+
+	//	Control_1, Control_5, CLKOUT_ctl + Timestp_ctl1, Timestp_ctl2 and INT_A_MASK1..INT_B_MASK2
+	fail	+= check( "apply() from reset state: transfers", bus.count, reads + bursts );
+	fail	+= check( "apply() from reset state: write bursts", bursts, 5 );
+
+	fail	+= check_reg( "Control_1 (SI)", regs[ PCF2131_base::Control_1 ], 0x01 );
+	fail	+= check_reg( "Control_5 (TSIE1, TSIE2)", regs[ PCF2131_base::Control_5 ], 0xC0 );
+	fail	+= check_reg( "INT_A_MASK1 (SI unmasked)", regs[ PCF2131_base::INT_A_MASK1 ], 0x2F );
+	fail	+= check_reg( "INT_B_MASK2 (TS1, TS2 unmasked)", regs[ PCF2131_base::INT_B_MASK2 ], 0x03 );
+	fail	+= check_reg( "Timestp_ctl1 (FIRST)", regs[ PCF2131_base::Timestp_ctl1 ], 0x80 );
+	fail	+= check_reg( "CLKOUT_ctl", regs[ PCF2131_base::CLKOUT_ctl ], RTC_NXP::FREQ_1_HZ );
+
+	fail	+= check( "registers different from individual calls", compare( image, regs ), 0 );
+
+	//	nothing changed: reads only
+
+	bus.count	= 0;
+	bursts		= rtc.apply( cfg );
+	fail	+= check( "apply() again: transfers", bus.count, reads );
+
+	//	moving the periodic interrupt to INT_B changes INT_A_MASK1 and INT_B_MASK1 (one register between)
+
+	cfg.periodic_int	= PCF2131_base::ROUTE_INT_B;
+
+	bus.count	= 0;
+	bursts		= rtc.apply( cfg );
+	fail	+= check( "periodic interrupt to INT_B: write bursts", bursts, 1 );
+	fail	+= check_reg( "INT_A_MASK1", regs[ PCF2131_base::INT_A_MASK1 ], 0x3F );
+	fail	+= check_reg( "INT_B_MASK1", regs[ PCF2131_base::INT_B_MASK1 ], 0x2F );
+
+	return fail ? 1 : 0;
+}
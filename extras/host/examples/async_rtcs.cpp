@@ -0,0 +1,110 @@
+/** async_rtcs: two RTCs serviced by coroutines on one event loop thread
+ *
+ *	PCF85063A and PCF2131 on fake bus with 300 us latency per transfer. 
+ *	Interrupts are made by a thread driving fake INT pins. 
+ *	Each RTC is serviced by a coroutine: wait interrupt -> clear -> read time. 
+ *
+ *	Needs C++20 (built with -std=gnu++20)
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <rtc_async.h>
+
+#include <atomic>
+
+const int	count	= 5;
+
+fake_register_bus	bus;
+
+rtc_task setup( rtc_async& a )
+{
+	struct tm	now_tm	= {};
+
+	now_tm.tm_year	= 2026 - 1900;
+	now_tm.tm_mon	= 6 - 1;
+	now_tm.tm_mday	= 27;
+	now_tm.tm_hour	= 18;
+	now_tm.tm_min	= 52;
+	now_tm.tm_sec	= 30;
+
+	co_await a.set( now_tm );
+	co_await a.alarm( RTC_NXP::SECOND, 0 );
+	
+	printf( "[%8lu us] time and alarm set\n", micros() );
+}
+
+rtc_task service( rtc_async& a, const char *name )
+{
+	for ( int i = 0; i < count; i++ )
+	{
+		co_await a.wait_for_interrupt();
+
+		unsigned long	start	= micros();
+		co_await a.int_clear();
+		time_t			t		= co_await a.rtc_time();
+		char			s[ 24 ];
+
+		strftime( s, sizeof( s ), "%FT%T", localtime( &t ) );
+		printf( "[%8lu us] %-9s interrupt #%d time=%s (serviced in %lu us)\n", 
+				start, name, i + 1, s, micros() - start );
+	}
+}
+
+//	Interrupt flag is set in fake register and INT pin is pulled down
+
+void interrupt( uint8_t addr, uint8_t reg, uint8_t flag, uint8_t pin )
+{
+	noInterrupts();
+	bus.regs( addr )[ reg ]	|= flag;
+	interrupts();
+
+	host_pin_input( pin, LOW );
+	delay( 1 );
+	host_pin_input( pin, HIGH );
+}
+
+int main( void )
+{
+	bus.enable( 0xA2 >> 1 );
+	bus.enable( 0xA6 >> 1 );
+	Wire.bus( &bus );
+
+	PCF85063A		rtc_a;
+	PCF2131_I2C		rtc_b;
+
+	rtc_a.begin();
+	rtc_b.begin();
+
+	bus.latency( 300 );
+
+	rtc_event_loop	loop;
+	fake_pin_int	int_a( 2 );
+	fake_pin_int	int_b( 3 );
+	rtc_async		a( rtc_a, loop, &int_a );
+	rtc_async		b( rtc_b, loop, &int_b );
+
+	setup( a );
+	setup( b );
+	service( a, "PCF85063A" );
+	service( b, "PCF2131" );
+
+	std::thread	device( []{
+		for ( int i = 0; i < count; i++ )
+		{
+			delay( 150 );
+			interrupt( 0xA2 >> 1, 0x01, 0x40, 2 );	//	PCF85063A Control_2 AF
+			delay( 50 );
+			interrupt( 0xA6 >> 1, 0x01, 0x10, 3 );	//	PCF2131 Control_2 AF
+		}
+	} );
+
+	loop.run();
+	device.join();
+
+	printf( "bus jobs: %lu, interrupts: %lu + %lu, all done in one loop thread\n", loop.bus_jobs(), int_a.events(), int_b.events() );
+
+	return 0;
+}
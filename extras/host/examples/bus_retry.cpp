@@ -0,0 +1,57 @@
+/** bus_retry: bus error handling with retry policy
+ *
+ *	Errors are injected on fake bus to see how accesses are retried 
+ *	and how long an access can take when the bus is disturbed
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <RTC_NXP.h>
+
+static const char	*status_name[]	= { "OK", "DATA_TOO_LONG", "NACK_ADDRESS", "NACK_DATA", "ERROR", "TIMEOUT", "DEADLINE" };
+
+static void try_read( PCF85063A& rtc, fake_register_bus& fake, int n_errors )
+{
+	uint8_t			bf[ 7 ];
+	unsigned long	start;
+	unsigned long	elapsed;
+	I2C_for_RTC::bus_status	s;
+
+	fake.inject_errors( n_errors );
+
+	start	= micros();
+	s		= rtc.try_reg_r( PCF85063A::Seconds, bf, sizeof( bf ) );
+	elapsed	= micros() - start;
+
+	printf( "%2d errors injected: %-13s in %5lu us, total retries %lu, total errors %lu\n", n_errors, status_name[ s ], elapsed, rtc.retries(), rtc.errors() );
+}
+
+int main( void )
+{
+	fake_register_bus	fake;
+	PCF85063A			rtc;
+
+	fake.enable( 0xA2 >> 1 );
+	fake.latency( 200 );
+	Wire.bus( &fake );
+
+	printf( "default policy: 2 retries, 100 us backoff, 5 ms deadline\n" );
+
+	for ( int i = 0; i < 5; i++ )
+		try_read( rtc, fake, i );
+
+	static const I2C_for_RTC::retry_policy	p	= { 10, 100, 2000 };	//	kept while used: not copied by retry()
+	rtc.retry( p );
+	rtc.clear_errors();
+
+	printf( "policy: 10 retries, 100 us backoff, 2 ms deadline\n" );
+
+	for ( int i = 0; i < 12; i += 3 )
+		try_read( rtc, fake, i );
+
+	fake.inject_errors( 0 );
+
+	return 0;
+}
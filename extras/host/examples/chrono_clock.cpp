@@ -0,0 +1,84 @@
+/** chrono_clock: std::chrono clock backed by RTC
+ *
+ *	usage: chrono_clock [DEVICE]
+ *	  DEVICE : /dev/i2c-N or fake:FILE (default: fake:/tmp/chrono_clock.regs)
+ *
+ *	Compares cost of rtc_nxp_clock::now() with reading RTC by time(). 
+ *	rtc_nxp_clock syncs to the RTC every second in this sample
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <RTC_NXP.h>
+#include <host_i2c_dev.h>
+
+typedef std::chrono::steady_clock	host_clock;
+
+int main( int argc, char *argv[] )
+{
+	const char		*dev	= ( argc > 1 ) ? argv[ 1 ] : "fake:/tmp/chrono_clock.regs";
+	bool			fake	= !strncmp( dev, "fake:", 5 );
+	host_i2c_dev	*i2c	= fake ? new fake_i2c_dev : new host_i2c_dev;
+	PCF2131_I2C		rtc;
+
+	if ( fake )
+		((fake_i2c_dev *)i2c)->enable( 0xA6 >> 1 );
+
+	if ( !i2c->open( fake ? dev + 5 : dev ) )
+	{
+		perror( dev );
+		return 1;
+	}
+
+	Wire.bus( i2c );
+
+	rtc.begin();
+	
+	if ( fake || rtc.oscillator_stop() )
+		rtc.set32( (uint32_t)(::time( NULL ) - RTC_NXP::time_2000()) );
+
+	RTC_monotonic	mono( rtc );
+
+	mono.begin();
+	rtc_nxp_clock::source( mono, 1 );
+
+	const int			repeat	= 1000;
+	host_clock::time_point	start;
+	double				ns;
+
+	i2c->clear_counts();
+	start	= host_clock::now();
+	for ( int i = 0; i < repeat; i++ )
+		rtc.time( NULL );
+	ns	= std::chrono::duration<double, std::nano>( host_clock::now() - start ).count() / repeat;
+	printf( "rtc.time()            : %8.1f ns, %.3f syscalls per call\n", ns, (double)i2c->syscalls() / repeat );
+
+	unsigned long	n		= 0;
+
+	i2c->clear_counts();
+	start	= host_clock::now();
+	
+	rtc_nxp_clock::time_point	prev	= rtc_nxp_clock::now();
+	unsigned long				back	= 0;
+
+	for ( ; host_clock::now() - start < std::chrono::seconds( 3 ); n++ )	//	includes cost of host_clock::now()
+	{
+		rtc_nxp_clock::time_point	t	= rtc_nxp_clock::now();
+		
+		if ( t < prev )
+			back++;
+		
+		prev	= t;
+	}
+	ns	= std::chrono::duration<double, std::nano>( host_clock::now() - start ).count() / n;
+	printf( "rtc_nxp_clock::now()  : %8.1f ns, %.6f syscalls per call (%lu syncs), %lu backward steps\n", ns, (double)i2c->syscalls() / n, (unsigned long)rtc_nxp_clock::syncs(), back );
+
+	time_t	t	= rtc_nxp_clock::to_time_t( rtc_nxp_clock::now() );
+	printf( "now: %s", ctime( &t ) );
+
+	delete i2c;
+
+	return 0;
+}
@@ -0,0 +1,78 @@
+/** drift_meter: offset and drift between RTCs on simulated chips
+ *
+ *	usage: drift_meter [SECONDS [PPM1 [PPM2 [FILE]]]]
+ *	  SECONDS : measurement time (default: 30)
+ *	  PPM1    : frequency error of PCF85263A (default: +50)
+ *	  PPM2    : frequency error of PCF85063A (default: -30)
+ *	  FILE    : samples are written in binary format to FILE (default: CSV to stdout)
+ *
+ *	Three RTCs are simulated: PCF2131 (0 ppm reference), PCF85263A and PCF85063A.
+ *	Those are set by RTC_group and sampled by RTC_drift_meter every second,
+ *	same as it is done on MCU with real chips.
+ *	Drift in the report should be close to the given ppm after some ten seconds.
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <RTC_NXP.h>
+#include <sim_rtc.h>
+
+static sim_rtc_bus	sim;
+
+int main( int argc, char *argv[] )
+{
+	int			seconds	= ( argc > 1 ) ? atoi( argv[ 1 ] ) : 30;
+	double		ppm1	= ( argc > 2 ) ? atof( argv[ 2 ] ) : +50.0;
+	double		ppm2	= ( argc > 3 ) ? atof( argv[ 3 ] ) : -30.0;
+	const char	*path	= ( argc > 4 ) ? argv[ 4 ] : NULL;
+	FILE		*fp		= path ? fopen( path, "wb" ) : stdout;
+
+	if ( !fp )
+	{
+		perror( path );
+		return 1;
+	}
+
+	sim.add( 0x53, sim_rtc_bus::PCF2131 );
+	sim.add( 0x51, sim_rtc_bus::PCF85263, ppm1 );
+	sim.add( 0x52, sim_rtc_bus::PCF85063, ppm2 );
+	Wire.bus( &sim );
+
+	PCF2131_I2C	rtc0( 0x53 );
+	PCF85263A	rtc1( 0x51 );
+	PCF85063A	rtc2( 0x52 );
+
+	RTC_NXP		*devices[]	= { &rtc0, &rtc1, &rtc2 };
+	RTC_group	group( devices, 3 );
+
+	group.set32( (uint32_t)(::time( NULL ) - RTC_NXP::time_2000()) );
+
+	RTC_drift_meter::track	tracks[ 3 ];
+	RTC_drift_meter			meter( group, tracks );
+	FilePrint				out( fp );
+
+	meter.output( out, path ? RTC_drift_meter::BINARY : RTC_drift_meter::CSV );
+
+	for ( int i = 0; i < seconds; i++ )
+	{
+		if ( !meter.sample() )
+			fprintf( stderr, "sample failed\n" );
+
+		fflush( fp );
+	}
+
+	if ( path )
+	{
+		fclose( fp );
+		printf( "%lu samples written to %s\n", (unsigned long)meter.samples(), path );
+	}
+
+	printf( "\nexpected drift_ppm: 0,1 = %+.3f, 0,2 = %+.3f, 1,2 = %+.3f\n", -ppm1, -ppm2, ppm1 - ppm2 );
+
+	FilePrint	console( stdout );
+	meter.report( console );
+
+	return 0;
+}
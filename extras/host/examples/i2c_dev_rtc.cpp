@@ -0,0 +1,145 @@
+/** i2c_dev_rtc: RTC on Linux i2c-dev
+ *
+ *	usage: i2c_dev_rtc [-f] DEVICE [CHIP]
+ *	  -f     : access the RTC even if a kernel driver is bound to it (SMBus transfers only)
+ *	  DEVICE : /dev/i2c-N, fake:FILE (file-backed fake) or fake-smbus:FILE (fake with SMBus only)
+ *	  CHIP   : PCF85063A (default), PCF85263A, PCF85053A or PCF2131
+ *
+ *	Shows current time and number of system calls per operation. 
+ *	Configuration snapshot is taken and restored to see long transfers (split into 32 byte blocks on SMBus). 
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <RTC_NXP.h>
+#include <host_i2c_dev.h>
+
+//	last register: register address wraps to 0 after this on the chip (used by the fake)
+
+static RTC_NXP *create( const char *chip, uint8_t *addr, uint8_t *last )
+{
+	*last	= 0xFF;
+
+	if ( !strcmp( chip, "PCF85263A" ) )	{ *addr = 0xA2 >> 1;	*last = 0x2F;	return new PCF85263A; }
+	if ( !strcmp( chip, "PCF85053A" ) )	{ *addr = 0xDE >> 1;					return new PCF85053A; }
+	if ( !strcmp( chip, "PCF2131" ) )	{ *addr = 0xA6 >> 1;					return new PCF2131_I2C; }
+	if ( !strcmp( chip, "PCF85063A" ) )	{ *addr = 0xA2 >> 1;	*last = 0x11;	return new PCF85063A; }
+
+	return NULL;
+}
+
+int main( int argc, char *argv[] )
+{
+	bool			force	= ( argc > 1 ) && !strcmp( argv[ 1 ], "-f" );
+
+	if ( force )
+	{
+		argc--;
+		argv++;
+	}
+
+	const char		*chip	= ( argc > 2 ) ? argv[ 2 ] : "PCF85063A";
+	host_i2c_dev	*i2c;
+	bool			fake_dev	= false;
+	RTC_NXP			*rtc;
+	uint8_t			addr;
+	uint8_t			last;
+	char			s[ 24 ];
+
+	if ( argc < 2 )
+	{
+		fprintf( stderr, "usage: %s [-f] DEVICE [CHIP]\n", argv[ 0 ] );
+		return 1;
+	}
+
+	if ( !(rtc = create( chip, &addr, &last )) )
+	{
+		fprintf( stderr, "unknown chip: %s\n", chip );
+		return 1;
+	}
+
+	if ( !strncmp( argv[ 1 ], "fake", 4 ) && strchr( argv[ 1 ], ':' ) )
+	{
+		fake_i2c_dev	*fake	= new fake_i2c_dev( !strncmp( argv[ 1 ], "fake-smbus:", 11 ) );
+
+		fake->enable( addr );
+		fake->wrap( addr, last );
+		i2c			= fake;
+		fake_dev	= true;
+	}
+	else
+	{
+		i2c	= new host_i2c_dev;
+	}
+
+	if ( !i2c->open( strchr( argv[ 1 ], ':' ) ? strchr( argv[ 1 ], ':' ) + 1 : argv[ 1 ] ) )
+	{
+		perror( argv[ 1 ] );
+		return 1;
+	}
+
+	i2c->force( force );
+	Wire.bus( i2c );
+
+	printf( "%s on %s (%s transfers)\n", chip, argv[ 1 ], i2c->smbus() ? "SMBus" : "I2C_RDWR" );
+
+	rtc->begin();
+
+	if ( fake_dev || rtc->oscillator_stop() )
+	{
+		uint32_t	t	= (uint32_t)(::time( NULL ) - RTC_NXP::time_2000());
+
+		printf( "setting time from system clock\n" );
+		rtc->set32( t );
+
+		//	read back: one second can pass
+		if ( 1 < rtc->now32() - t )
+		{
+			fprintf( stderr, "time read back is not same as written: %s\n", rtc->iso8601( s ) );
+			return 1;
+		}
+	}
+
+	printf( "time: %s\n", rtc->iso8601( s ) );
+
+	const int	repeat	= 100;
+
+	i2c->clear_counts();
+	for ( int i = 0; i < repeat; i++ )
+		rtc->time( NULL );
+	printf( "time()      : %.1f syscalls, %.1f transfers per call\n", (float)i2c->syscalls() / repeat, (float)i2c->transfers() / repeat );
+
+	i2c->clear_counts();
+	for ( int i = 0; i < repeat; i++ )
+		rtc->int_clear();
+	printf( "int_clear() : %.1f syscalls, %.1f transfers per call\n", (float)i2c->syscalls() / repeat, (float)i2c->transfers() / repeat );
+
+	struct tm	alarm_tm;
+
+	memset( &alarm_tm, 0, sizeof( alarm_tm ) );
+	alarm_tm.tm_sec	= 30;
+	
+	i2c->clear_counts();
+	rtc->alarm_match( RTC_NXP::MATCH_SECOND, &alarm_tm );
+	printf( "alarm_match(): %lu syscalls, %lu transfers\n", i2c->syscalls(), i2c->transfers() );
+
+	uint8_t	blob[ RTC_NXP::SNAPSHOT_SIZE ];
+	uint8_t	size;
+	
+	i2c->clear_counts();
+	size	= rtc->snapshot( blob );
+	
+	if ( size )
+	{
+		bool	ok	= rtc->restore( blob );
+		
+		printf( "snapshot() + restore(): %s, %u bytes, %lu syscalls, %lu transfers\n", ok ? "OK" : "failed", size, i2c->syscalls(), i2c->transfers() );
+	}
+
+	delete rtc;
+	delete i2c;
+
+	return 0;
+}
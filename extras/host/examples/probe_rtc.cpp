@@ -0,0 +1,111 @@
+/** probe_rtc: finding RTC chip on the bus by RTC_probe
+ *
+ *	usage: probe_rtc [DEVICE]
+ *	  DEVICE : /dev/i2c-N (default: each simulated chip in turn)
+ *
+ *	Same firmware works on boards with different RTC variants.
+ *	Without DEVICE, RTC_probe is tried on simulated PCF2131, PCF85063A, PCF85063TP and PCF85263A
+ *	and on a register file at 0x6F which has the PCF85053A register map.
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <RTC_NXP.h>
+#include <host_i2c_dev.h>
+#include <sim_rtc.h>
+
+static RTC_probe::chip_type probe( void )
+{
+	RTC_probe	probe;
+	RTC_NXP		*rtc	= probe.create();
+	char		s[ 24 ];
+
+	if ( !rtc )
+	{
+		printf( "no RTC found\n" );
+		return RTC_probe::CHIP_NONE;
+	}
+
+	printf( "%-10s at 0x%02X : %s\n", probe.name(), probe.address(), rtc->iso8601( s ) );
+	delete rtc;
+
+	return probe.type();
+}
+
+int main( int argc, char *argv[] )
+{
+	if ( argc > 1 )
+	{
+		host_i2c_dev	i2c;
+
+		if ( !i2c.open( argv[ 1 ] ) )
+		{
+			perror( argv[ 1 ] );
+			return 1;
+		}
+
+		Wire.bus( &i2c );
+
+		return ( RTC_probe::CHIP_NONE != probe() ) ? 0 : 1;
+	}
+
+	const struct {
+		uint8_t					addr;
+		sim_rtc_bus::chip_type	type;
+		RTC_probe::chip_type	expected;
+		uint8_t					setup[ 3 ];	//	register address and 2 bytes written before probing (none if 0 bytes)
+		int						setup_len;
+	} chips[]	= {
+		{ 0xA6 >> 1, sim_rtc_bus::PCF2131,    RTC_probe::CHIP_PCF2131,    { 0 }, 0 },
+		{ 0xA2 >> 1, sim_rtc_bus::PCF85063,   RTC_probe::CHIP_PCF85063A,  { 0 }, 0 },
+		{ 0xA2 >> 1, sim_rtc_bus::PCF85063TP, RTC_probe::CHIP_PCF85063TP, { 0 }, 0 },
+		{ 0xA2 >> 1, sim_rtc_bus::PCF85263,   RTC_probe::CHIP_PCF85263A,  { 0 }, 0 },
+
+		//	PCF85063A with Second_alarm and Minute_alarm same as Control_1 and Control_2
+		{ 0xA2 >> 1, sim_rtc_bus::PCF85063,   RTC_probe::CHIP_PCF85063A,  { 0x0B, 0x00, 0x00 }, 3 },
+
+		//	PCF85263A with 100th-seconds counting (100TH in Function register is set). Above is with the reset value 0
+		{ 0xA2 >> 1, sim_rtc_bus::PCF85263,   RTC_probe::CHIP_PCF85263A,  { 0x28, 0x80 }, 2 },
+
+		//	PCF85263A with the clock stopped by Stop_enable
+		{ 0xA2 >> 1, sim_rtc_bus::PCF85263,   RTC_probe::CHIP_PCF85263A,  { 0x2E, 0x01 }, 2 },
+	};
+
+	int	fail	= 0;
+
+	for ( unsigned int i = 0; i < sizeof( chips ) / sizeof( chips[ 0 ] ); i++ )
+	{
+		sim_rtc_bus	sim;
+
+		sim.add( chips[ i ].addr, chips[ i ].type, 0.0, 86400 * 7 );
+		Wire.bus( &sim );
+
+		if ( chips[ i ].setup_len )
+			sim.i2c_transfer( chips[ i ].addr, chips[ i ].setup, chips[ i ].setup_len, NULL, 0 );
+
+		fail	+= ( chips[ i ].expected != probe() );
+	}
+
+	//	PCF85053A: time registers with alarm registers in between (2000-01-01 00:00:00, Saturday)
+	fake_register_bus	fake;
+	const uint8_t		regs[]	= { 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x06, 0x01, 0x01, 0x00 };
+
+	memcpy( fake.regs( 0xDE >> 1 ), regs, sizeof( regs ) );
+	fake.enable( 0xDE >> 1 );
+	Wire.bus( &fake );
+
+	fail	+= ( RTC_probe::CHIP_PCF85053A != probe() );
+
+	//	a device with other register map at 0x51 is not taken
+	fake_register_bus	other;
+
+	memset( other.regs( 0xA2 >> 1 ), 0xFF, 256 );
+	other.enable( 0xA2 >> 1 );
+	Wire.bus( &other );
+
+	fail	+= ( RTC_probe::CHIP_NONE != probe() );
+
+	return fail ? 1 : 0;
+}
@@ -0,0 +1,62 @@
+/** shared_bus_threads: RTCs on a shared bus accessed from multiple threads
+ *
+ *	Two threads set and read time of two RTCs on same TwoWire. 
+ *	Both devices share one RTC_std_lock, so each set32()/now32() is done atomically. 
+ *	PCF2131 waits 100 ms for OTP refresh in set32() without holding the lock. 
+ *	Lock holding time and waiting time are reported. 
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <RTC_NXP.h>
+#include <thread>
+
+static fake_register_bus	fake;
+static RTC_std_lock			lock;
+static PCF85063A			rtc_a;
+static PCF2131_I2C			rtc_b;
+
+static void worker( RTC_NXP *rtc, uint32_t base, unsigned long *errors )
+{
+	for ( uint32_t i = 0; i < 20; i++ )
+	{
+		rtc->set32( base + i );	//	each thread has its own device: read back is not disturbed by other thread
+		
+		if ( rtc->now32() != base + i )
+			(*errors)++;
+	}
+}
+
+int main( void )
+{
+	unsigned long	errors_a	= 0;
+	unsigned long	errors_b	= 0;
+
+	fake.enable( 0xA2 >> 1 );
+	fake.enable( 0xA6 >> 1 );
+	fake.latency( 20 );
+	Wire.bus( &fake );
+
+	rtc_a.bus_lock( &lock );
+	rtc_b.bus_lock( &lock );
+
+	std::thread	thread_a( worker, &rtc_a, 0, &errors_a );
+	std::thread	thread_b( worker, &rtc_b, 100000000, &errors_b );
+
+	//	PCF2131 takes 100 ms for OTP refresh in set32(). Check the other device from main thread meanwhile
+	for ( int i = 0; i < 10; i++ )
+	{
+		rtc_a.int_clear();
+		delay( 10 );
+	}
+
+	thread_a.join();
+	thread_b.join();
+
+	printf( "read back errors: %lu, %lu\n", errors_a, errors_b );
+	printf( "lock: %lu acquisitions, hold time mean %.1f us, max %lu us, max wait %lu us\n", lock.count(), lock.hold_mean(), lock.hold_max(), lock.wait_max() );
+
+	return ( errors_a || errors_b ) ? 1 : 0;
+}
@@ -0,0 +1,116 @@
+/** snapshot_restore: configuration restore after battery loss
+ *
+ *	Each chip is configured by driver calls and its configuration is taken by snapshot().
+ *	Then the register file is cleared (battery loss) and restored from the blob.
+ *	Number of bus transfers is shown for configuring and restoring.
+ *	Differences after restore are bits to keep interrupt flags, which are plain bits on the fake.
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <RTC_NXP.h>
+
+class counting_bus : public fake_register_bus
+{
+public:
+	counting_bus() : count( 0 ) {}
+
+	int i2c_transfer( uint8_t addr, const uint8_t *wp, int wn, uint8_t *rp, int rn )
+	{
+		count++;
+		return fake_register_bus::i2c_transfer( addr, wp, wn, rp, rn );
+	}
+
+	int	count;
+};
+
+static counting_bus	bus;
+
+static void configure( RTC_NXP& rtc )
+{
+	struct tm	alarm_tm	= {};
+
+	alarm_tm.tm_hour	= 7;
+	alarm_tm.tm_min		= 30;
+	alarm_tm.tm_mday	= 1;
+	alarm_tm.tm_mon		= 0;
+
+	rtc.alarm_match( RTC_NXP::MATCH_HOUR | RTC_NXP::MATCH_MINUTE, &alarm_tm );
+	rtc.set_clock_out( RTC_NXP::FREQ_1_HZ );
+}
+
+static int run( const char* name, RTC_NXP& rtc, uint8_t addr )
+{
+	uint8_t	blob[ RTC_NXP::SNAPSHOT_SIZE ];
+	uint8_t	check[ RTC_NXP::SNAPSHOT_SIZE ];
+	uint8_t	*regs	= bus.regs( addr );
+	uint8_t	size;
+
+	memset( regs, 0, 256 );
+
+	bus.count	= 0;
+	configure( rtc );
+	printf( "%-10s configured by driver calls : %2d transfers\n", name, bus.count );
+
+	bus.count	= 0;
+	size		= rtc.snapshot( blob );
+	printf( "%-10s snapshot                   : %2d transfers, %2d bytes blob:", name, bus.count, size );
+
+	for ( int i = 0; i < size; i++ )
+		printf( " %02X", blob[ i ] );
+
+	printf( "\n" );
+
+	memset( regs, 0, 256 );	//	battery loss
+
+	bus.count	= 0;
+	rtc.restore( blob );
+	printf( "%-10s restore                    : %2d transfers\n", name, bus.count );
+
+	//	fake register file does not have flags: bits written as 1 to keep flags are seen as differences
+
+	rtc.snapshot( check );
+
+	for ( int i = 2; i < size; i++ )
+	{
+		if ( blob[ i ] != check[ i ] )
+			printf( "%-10s   blob[ %2d ] %02X -> %02X (flag bits)\n", name, i, blob[ i ], check[ i ] );
+	}
+
+	return ( size && (blob[ 0 ] == check[ 0 ]) ) ? 0 : 1;
+}
+
+int main( void )
+{
+	PCF2131_I2C	pcf2131;
+	PCF85063A	pcf85063a;
+	PCF85063TP	pcf85063tp;
+	PCF85263A	pcf85263a;
+	PCF85053A	pcf85053a;
+
+	bus.enable( 0xA6 >> 1 );
+	bus.enable( 0xA2 >> 1 );
+	bus.enable( 0xDE >> 1 );
+	Wire.bus( &bus );
+
+	int	fail	= 0;
+
+	fail	+= run( "PCF2131",   pcf2131,   0xA6 >> 1 );
+	fail	+= run( "PCF85063A", pcf85063a, 0xA2 >> 1 );
+	fail	+= run( "PCF85263A", pcf85263a, 0xA2 >> 1 );
+	fail	+= run( "PCF85053A", pcf85053a, 0xDE >> 1 );
+
+	//	PCF85063TP: register address wraps after Years (0x0A). Control_2 has no flag to keep: no difference after restore
+	bus.wrap( 0xA2 >> 1, 0x0A );
+	fail	+= run( "PCF85063TP", pcf85063tp, 0xA2 >> 1 );
+
+	//	a blob is taken only by same type of device
+	uint8_t	blob[ RTC_NXP::SNAPSHOT_SIZE ];
+
+	pcf2131.snapshot( blob );
+	fail	+= pcf85063a.restore( blob ) ? 1 : 0;
+
+	return fail ? 1 : 0;
+}
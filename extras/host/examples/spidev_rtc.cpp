@@ -0,0 +1,82 @@
+/** spidev_rtc: PCF2131 on Linux spidev
+ *
+ *	usage: spidev_rtc DEVICE [SPEED_HZ]
+ *	  DEVICE   : /dev/spidevX.Y or fake (in-process fake)
+ *	  SPEED_HZ : SCK frequency (default 1000000)
+ *
+ *	Shows current time and number of system calls per operation
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <RTC_NXP.h>
+#include <host_spidev.h>
+
+int main( int argc, char *argv[] )
+{
+	host_spidev	*spi;
+	bool		fake_dev;
+	uint32_t	speed	= ( argc > 2 ) ? strtoul( argv[ 2 ], NULL, 0 ) : 1000000;
+	char		s[ 24 ];
+
+	if ( argc < 2 )
+	{
+		fprintf( stderr, "usage: %s DEVICE [SPEED_HZ]\n", argv[ 0 ] );
+		return 1;
+	}
+
+	fake_dev	= !strcmp( argv[ 1 ], "fake" );
+	spi			= fake_dev ? new fake_spidev : new host_spidev;
+
+	if ( !spi->open( argv[ 1 ], speed, SPI_MODE0 ) )
+	{
+		perror( argv[ 1 ] );
+		return 1;
+	}
+
+	SPI.bus( spi );
+
+	PCF2131_SPI	rtc;
+
+	printf( "PCF2131 on %s (%lu Hz)\n", argv[ 1 ], (unsigned long)speed );
+
+	rtc.begin();
+
+	if ( fake_dev || rtc.oscillator_stop() )
+	{
+		printf( "setting time from system clock\n" );
+		rtc.set32( (uint32_t)(::time( NULL ) - RTC_NXP::time_2000()) );
+	}
+
+	printf( "time: %s\n", rtc.iso8601( s ) );
+
+	const int	repeat	= 100;
+
+	spi->clear_counts();
+	for ( int i = 0; i < repeat; i++ )
+		rtc.rtc_time();
+	printf( "rtc_time()  : %.1f syscalls, %.1f messages per call", (float)spi->syscalls() / repeat, (float)spi->messages() / repeat );
+	if ( fake_dev )
+		printf( " (%d segments per message)", ((fake_spidev *)spi)->last_segments() );
+	printf( "\n" );
+
+	spi->clear_counts();
+	for ( int i = 0; i < repeat; i++ )
+		rtc.int_clear();
+	printf( "int_clear() : %.1f syscalls, %.1f messages per call\n", (float)spi->syscalls() / repeat, (float)spi->messages() / repeat );
+
+	struct tm	alarm_tm;
+
+	memset( &alarm_tm, 0, sizeof( alarm_tm ) );
+	alarm_tm.tm_sec	= 30;
+	
+	spi->clear_counts();
+	rtc.alarm_match( RTC_NXP::MATCH_SECOND, &alarm_tm );
+	printf( "alarm_match(): %lu syscalls, %lu messages\n", spi->syscalls(), spi->messages() );
+
+	delete spi;
+
+	return 0;
+}
@@ -0,0 +1,112 @@
+/** timebase_tick: RTC_timebase on PCF2131 every minute interrupt
+ *
+ *	periodic_interrupt_enable() is checked to set only the selected interrupt (MI or SI).
+ *	Then interrupt edges are given by hand and callback timing of RTC_timebase is checked,
+ *	with the clock on a register file (not running) so that RTC time is known.
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <RTC_NXP.h>
+
+static fake_register_bus	bus;
+static int					n_calls;
+static uint32_t				last_call;
+
+static int check( const char* name, long value, long expected )
+{
+	printf( "%-46s : %6ld%s\n", name, value, (value == expected) ? "" : "  *** unexpected ***" );
+
+	return (value == expected) ? 0 : 1;
+}
+
+static void task( uint32_t t )
+{
+	n_calls++;
+	last_call	= t;
+}
+
+//	give n edges, then service them by one update()
+
+static void ticks( RTC_timebase& tb, int n )
+{
+	while ( n-- )
+		tb.edge();
+
+	tb.update();
+}
+
+int main( void )
+{
+	PCF2131_I2C	rtc;
+	uint8_t		*regs	= bus.regs( 0xA6 >> 1 );
+	int			fail	= 0;
+
+	bus.enable( 0xA6 >> 1 );
+	Wire.bus( &bus );
+
+	//	interrupt selection
+
+	regs[ PCF2131_base::INT_A_MASK1 ]	= 0x3F;	//	reset state: all interrupts masked
+
+	rtc.periodic_interrupt_enable( PCF2131_base::EVERY_MINUTE, 0 );
+	fail	+= check( "EVERY_MINUTE: Control_1 SI/MI bits", regs[ PCF2131_base::Control_1 ] & 0x03, 0x02 );
+	fail	+= check( "EVERY_MINUTE: INT_A_MASK1", regs[ PCF2131_base::INT_A_MASK1 ], 0x1F );
+
+	rtc.periodic_interrupt_enable( PCF2131_base::EVERY_SECOND, 0 );
+	fail	+= check( "EVERY_SECOND: Control_1 SI/MI bits", regs[ PCF2131_base::Control_1 ] & 0x03, 0x01 );
+	fail	+= check( "EVERY_SECOND: INT_A_MASK1", regs[ PCF2131_base::INT_A_MASK1 ], 0x2F );
+
+	rtc.periodic_interrupt_enable( PCF2131_base::DISABLE, 0 );
+	fail	+= check( "DISABLE: INT_A_MASK1", regs[ PCF2131_base::INT_A_MASK1 ], 0x3F );
+
+	//	every 5 minutes on every minute ticks
+
+	const uint32_t	t0	= 3000;	//	multiple of 300
+	RTC_timebase	tb( rtc, 60 );
+
+	rtc.set32( t0 );
+	tb.callback( task, 300 );
+	tb.begin();
+
+	ticks( tb, 1 );
+	fail	+= check( "first tick on the boundary: calls", n_calls, 1 );
+
+	for ( int i = 0; i < 10; i++ )
+		ticks( tb, 1 );
+
+	fail	+= check( "10 minutes: calls", n_calls, 3 );
+	fail	+= check( "10 minutes: last call time", last_call, t0 + 600 );
+
+	//	boundary is passed while update() is not called: called once at the tick after it
+
+	ticks( tb, 2 );
+	ticks( tb, 4 );
+	fail	+= check( "boundary in 4 ticks at once: calls", n_calls, 4 );
+	fail	+= check( "boundary in 4 ticks at once: last call time", last_call, t0 + 960 );
+
+	//	phase which is not a multiple of the tick period: called at next tick
+
+	n_calls	= 0;
+	tb.callback( task, 300, 90 );
+
+	for ( int i = 0; i < 5; i++ )
+		ticks( tb, 1 );
+
+	fail	+= check( "phase 90 s on minute ticks: calls", n_calls, 1 );
+	fail	+= check( "phase 90 s on minute ticks: last call time", last_call % 300, 120 );
+
+	//	interval 0 is taken as 1: called on every tick
+
+	n_calls	= 0;
+	tb.callback( task, 0 );
+
+	for ( int i = 0; i < 3; i++ )
+		ticks( tb, 1 );
+
+	fail	+= check( "interval 0: calls", n_calls, 3 );
+
+	return fail ? 1 : 0;
+}
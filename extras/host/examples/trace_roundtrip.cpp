@@ -0,0 +1,85 @@
+/** trace_roundtrip: record and replay a bus trace on host
+ *
+ *	A PCF85063A session is run on a fake register bus and recorded into a file. 
+ *	The same session is run again against the trace by RTC_bus_replayer to verify it. 
+ *	Bus errors are injected while recording: the failed tries and retries are replayed as recorded. 
+ *	A trace captured on target (e.g. RTC_bus_recorder writing to SD file) can be 
+ *	verified in same way by running code that was on the target. 
+ *
+ *	usage: trace_roundtrip [trace_file]
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <RTC_NXP.h>
+#include <RTC_bus_replayer.h>
+
+static void session( void )
+{
+	PCF85063A	rtc;
+	char		s[ 24 ];
+
+	rtc.begin();
+	rtc.set32( 0 );
+	rtc.alarm( PCF85063A::SECOND, 30 );
+
+	for ( int i = 0; i < 3; i++ )
+		Serial.println( rtc.iso8601( s ) );
+
+	rtc.int_clear();
+}
+
+int main( int argc, char *argv[] )
+{
+	const char	*path	= ( argc > 1 ) ? argv[ 1 ] : "trace.bin";
+
+	//	record
+	{
+		fake_register_bus	fake;
+		FILE				*fp	= fopen( path, "wb" );
+
+		if ( !fp )
+		{
+			perror( path );
+			return 1;
+		}
+
+		fake.enable( 0xA2 >> 1 );
+		fake.inject_errors( 2 );
+		Wire.bus( &fake );
+
+		FilePrint			out( fp );
+		RTC_bus_recorder	recorder( out );
+
+		recorder.start();
+		session();
+		recorder.marker( 1 );
+		recorder.stop();
+
+		printf( "recorded %lu records into %s\n", recorder.records(), path );
+		fclose( fp );
+	}
+
+	//	replay
+	{
+		RTC_trace_reader	trace;
+
+		if ( !trace.open( path ) )
+		{
+			fprintf( stderr, "%s: %s\n", path, trace.error() );
+			return 1;
+		}
+
+		RTC_bus_replayer	replayer( trace );
+
+		Wire.bus( &replayer );
+		session();
+		Wire.bus( NULL );
+
+		replayer.report( stdout );
+
+		return ( replayer.mismatches() || !replayer.finished() ) ? 1 : 0;
+	}
+}
@@ -0,0 +1,86 @@
+/** trace_timeline: driver method timeline in chrome://tracing format
+ *
+ *	usage: trace_timeline [FILE]
+ *	  FILE : output JSON (default: rtc_trace.json)
+ *
+ *	Two threads access two RTCs on a shared fake bus with injected errors. 
+ *	Method enter/exit, interrupt flags and bus retries are written to FILE. 
+ *	Load it in chrome://tracing or https://ui.perfetto.dev to see the timeline. 
+ *	Last part is also kept in RTC_trace_buffer and printed, as it is done on MCU. 
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <RTC_NXP.h>
+#include <RTC_trace_json.h>
+#include <thread>
+
+static fake_register_bus	fake;
+static RTC_std_lock			lock;
+static PCF85063A			rtc_a;
+static PCF2131_I2C			rtc_b;
+
+static void worker( RTC_NXP *rtc, uint32_t base )
+{
+	for ( uint32_t i = 0; i < 5; i++ )
+	{
+		rtc->set32( base + i );
+		rtc->now32();
+		rtc->int_clear();
+	}
+}
+
+int main( int argc, char *argv[] )
+{
+	const char	*path	= ( argc > 1 ) ? argv[ 1 ] : "rtc_trace.json";
+	FILE		*fp		= fopen( path, "w" );
+
+	if ( !fp )
+	{
+		perror( path );
+		return 1;
+	}
+
+	fake.enable( 0xA2 >> 1 );
+	fake.enable( 0xA6 >> 1 );
+	fake.latency( 20 );
+	Wire.bus( &fake );
+
+	rtc_a.bus_lock( &lock );
+	rtc_b.bus_lock( &lock );
+
+	RTC_trace_json	json( fp );
+	RTC_trace::sink( &json );
+
+	std::thread	thread_a( worker, &rtc_a, 0 );
+	std::thread	thread_b( worker, &rtc_b, 100000000 );
+
+	thread_a.join();
+	thread_b.join();
+
+	fake.inject_errors( 2 );
+	rtc_a.now32();
+
+	RTC_trace::sink( nullptr );
+	json.close();
+
+	printf( "%lu events written to %s\n", json.events(), path );
+
+	//	same on MCU: keep last records in RAM and dump those to Serial
+	static RTC_trace_buffer::record	records[ 8 ];
+	RTC_trace_buffer				buffer( records, 8 );
+
+	RTC_trace::sink( &buffer );
+	rtc_a.int_clear();
+	rtc_a.time( NULL );
+	fake.inject_errors( 1 );
+	rtc_a.oscillator_stop();
+	RTC_trace::sink( nullptr );
+
+	printf( "last %u records (%lu overwritten):\n", buffer.available(), (unsigned long)buffer.overwritten() );
+	buffer.dump( Serial );
+
+	return 0;
+}
@@ -0,0 +1,130 @@
+#include <host_bus.h>
+
+fake_register_bus::fake_register_bus() : error_count( 0 ), error_status( 0 ), latency_us( 0 )
+{
+	memset( i2c_reg, 0, sizeof( i2c_reg ) );
+	memset( i2c_ptr, 0, sizeof( i2c_ptr ) );
+	memset( i2c_last, 0xFF, sizeof( i2c_last ) );
+	memset( present, 0, sizeof( present ) );
+	memset( spi_reg, 0, sizeof( spi_reg ) );
+}
+
+fake_register_bus::~fake_register_bus()
+{
+}
+
+uint8_t *fake_register_bus::regs( uint8_t addr )
+{
+	return i2c_reg[ addr & 0x7F ];
+}
+
+uint8_t *fake_register_bus::spi_regs( void )
+{
+	return spi_reg;
+}
+
+void fake_register_bus::enable( uint8_t addr )
+{
+	present[ addr & 0x7F ]	= true;
+}
+
+void fake_register_bus::wrap( uint8_t addr, uint8_t last )
+{
+	i2c_last[ addr & 0x7F ]	= last;
+}
+
+void fake_register_bus::inject_errors( int count, int status )
+{
+	error_count		= count;
+	error_status	= status;
+}
+
+void fake_register_bus::latency( unsigned long us )
+{
+	latency_us	= us;
+}
+
+int fake_register_bus::i2c_transfer( uint8_t addr, const uint8_t *wp, int wn, uint8_t *rp, int rn )
+{
+	addr	&= 0x7F;
+
+	if ( latency_us )
+		delayMicroseconds( latency_us );
+
+	if ( !present[ addr ] )
+		return 2;
+
+	if ( error_count )
+	{
+		error_count--;
+		return error_status;
+	}
+
+	if ( wn )
+	{
+		i2c_ptr[ addr ]	= *wp++;
+
+		while ( --wn )
+		{
+			i2c_reg[ addr ][ i2c_ptr[ addr ] ]	= *wp++;
+			i2c_ptr[ addr ]	= ( i2c_ptr[ addr ] == i2c_last[ addr ] ) ? 0 : i2c_ptr[ addr ] + 1;
+		}
+	}
+
+	while ( rn-- )
+	{
+		*rp++	= i2c_reg[ addr ][ i2c_ptr[ addr ] ];
+		i2c_ptr[ addr ]	= ( i2c_ptr[ addr ] == i2c_last[ addr ] ) ? 0 : i2c_ptr[ addr ] + 1;
+	}
+
+	return 0;
+}
+
+void fake_register_bus::spi_transfer( uint8_t *data, int size )
+{
+	if ( !size )
+		return;
+
+	bool	read	= data[ 0 ] & 0x80;
+	uint8_t	ptr		= data[ 0 ] & 0x7F;
+
+	data[ 0 ]	= 0xFF;
+
+	for ( int i = 1; i < size; i++ )
+	{
+		if ( read )
+			data[ i ]	= spi_reg[ ptr ];
+		else
+			spi_reg[ ptr ]	= data[ i ];
+
+		ptr	= (ptr + 1) & 0x7F;
+	}
+}
+
+void host_spi_bus::spi_message( const host_spi_segment *seg, int count )
+{
+	int	total	= 0;
+
+	for ( int i = 0; i < count; i++ )
+		total	+= seg[ i ].size;
+
+	uint8_t	buf[ total ? total : 1 ];
+	uint8_t	*p	= buf;
+
+	for ( int i = 0; i < count; p += seg[ i++ ].size )
+	{
+		if ( seg[ i ].tx )
+			memcpy( p, seg[ i ].tx, seg[ i ].size );
+		else
+			memset( p, 0xFF, seg[ i ].size );
+	}
+
+	spi_transfer( buf, total );
+
+	p	= buf;
+	for ( int i = 0; i < count; p += seg[ i++ ].size )
+	{
+		if ( seg[ i ].rx )
+			memcpy( seg[ i ].rx, p, seg[ i ].size );
+	}
+}
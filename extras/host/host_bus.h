@@ -0,0 +1,145 @@
+/** Bus backend interfaces for Linux host build of RTC_NXP_Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef RTC_NXP_HOST_BUS_H
+#define RTC_NXP_HOST_BUS_H
+
+#include <Arduino.h>
+
+/** host_i2c_bus class
+ *	
+ *	Backend of TwoWire on host. 
+ *	Write and read in one call is a combined transfer (write, repeated-START, read)
+ *
+ *  @class host_i2c_bus
+ */
+
+class host_i2c_bus
+{
+public:
+	virtual ~host_i2c_bus() {}
+
+	/** I2C transfer
+	 *
+	 * @param addr 7 bit target address
+	 * @param wp pointer to write data
+	 * @param wn write data size (no write phase if 0)
+	 * @param rp pointer to read buffer
+	 * @param rn read data size (no read phase if 0)
+	 * @return status compatible to TwoWire::endTransmission(): 0 = success, 2 = NACK on address, 3 = NACK on data, 4 = other error
+	 */
+	virtual int i2c_transfer( uint8_t addr, const uint8_t *wp, int wn, uint8_t *rp, int rn )	= 0;
+};
+
+/** host_spi_segment struct
+ *	
+ *	A part of SPI message. Segments in a message are transferred in one chip-select period
+ */
+
+struct host_spi_segment
+{
+	const uint8_t	*tx;	//	data to be sent. 0x00 is sent if NULL
+	uint8_t			*rx;	//	buffer for received data. Discarded if NULL
+	int				size;
+};
+
+/** host_spi_bus class
+ *	
+ *	Backend of SPIClass on host
+ *
+ *  @class host_spi_bus
+ */
+
+class host_spi_bus
+{
+public:
+	virtual ~host_spi_bus() {}
+
+	/** SPI full-duplex transfer
+	 *
+	 * @param data pointer to data. Sent data is replaced by received data
+	 * @param size data size
+	 */
+	virtual void spi_transfer( uint8_t *data, int size )	= 0;
+
+	/** SPI message transfer
+	 *
+	 *	Default implementation gathers segments into a buffer and calls spi_transfer(). 
+	 *	Backends which can transfer the segments as those are (like spidev) override this. 
+	 *
+	 * @param seg pointer to segments
+	 * @param count number of segments
+	 */
+	virtual void spi_message( const host_spi_segment *seg, int count );
+};
+
+/** fake_register_bus class
+ *	
+ *	Register file fake of I2C and SPI targets to run the library without hardware. 
+ *	Each I2C address has 256 registers with auto-increment. 
+ *	SPI target takes register address in bit 6..0 of first byte and read flag in bit 7. 
+ *
+ *  @class fake_register_bus
+ */
+
+class fake_register_bus : public host_i2c_bus, public host_spi_bus
+{
+public:
+	fake_register_bus();
+	virtual ~fake_register_bus();
+
+	/** Register content of I2C target
+	 *
+	 * @param addr 7 bit target address
+	 * @return pointer to 256 bytes register file
+	 */
+	uint8_t	*regs( uint8_t addr );
+
+	/** Register content of SPI target
+	 *
+	 * @return pointer to 128 bytes register file
+	 */
+	uint8_t	*spi_regs( void );
+
+	/** Enable an I2C target address (all addresses NACK until enabled) */
+	void	enable( uint8_t addr );
+
+	/** Register address wrap-around of an I2C target
+	 *
+	 * @param addr 7 bit target address
+	 * @param last last register. Auto-increment goes to register 0 after this (default: 0xFF)
+	 */
+	void	wrap( uint8_t addr, uint8_t last );
+
+	/** Make following I2C transfers fail
+	 *
+	 * @param count number of transfers to fail
+	 * @param status status to be returned
+	 */
+	void	inject_errors( int count, int status = 2 );
+
+	/** Time taken for each I2C transfer
+	 *
+	 * @param us microseconds
+	 */
+	void	latency( unsigned long us );
+
+	int		i2c_transfer( uint8_t addr, const uint8_t *wp, int wn, uint8_t *rp, int rn );
+	void	spi_transfer( uint8_t *data, int size );
+
+private:
+	uint8_t	i2c_reg[ 128 ][ 256 ];
+	uint8_t	i2c_ptr[ 128 ];
+	uint8_t	i2c_last[ 128 ];
+	bool	present[ 128 ];
+	uint8_t	spi_reg[ 128 ];
+	int		error_count;
+	int		error_status;
+	unsigned long	latency_us;
+};
+
+#endif //	RTC_NXP_HOST_BUS_H
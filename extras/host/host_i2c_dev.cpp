@@ -0,0 +1,341 @@
+#include <host_i2c_dev.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+host_i2c_dev::host_i2c_dev() : fd( -1 ), use_smbus( false ), slave_addr( -1 ), force_addr( false ), n_transfers( 0 ), n_syscalls( 0 )
+{
+}
+
+host_i2c_dev::~host_i2c_dev()
+{
+	close();
+}
+
+bool host_i2c_dev::open( const char *path )
+{
+	unsigned long	funcs	= 0;
+
+	close();
+
+	if ( (fd = ::open( path, O_RDWR )) < 0 )
+		return false;
+
+	if ( sys_ioctl( I2C_FUNCS, &funcs ) < 0 )
+	{
+		close();
+		return false;
+	}
+
+	use_smbus	= !(funcs & I2C_FUNC_I2C);
+	slave_addr	= -1;
+
+	return true;
+}
+
+void host_i2c_dev::close( void )
+{
+	if ( fd >= 0 )
+		::close( fd );
+
+	fd	= -1;
+}
+
+int host_i2c_dev::sys_ioctl( unsigned long request, void *arg )
+{
+	n_syscalls++;
+	return do_ioctl( request, arg );
+}
+
+int host_i2c_dev::do_ioctl( unsigned long request, void *arg )
+{
+	return ioctl( fd, request, arg );
+}
+
+int host_i2c_dev::i2c_transfer( uint8_t addr, const uint8_t *wp, int wn, uint8_t *rp, int rn )
+{
+	struct i2c_msg				msg[ 2 ];
+	struct i2c_rdwr_ioctl_data	data;
+	int							n	= 0;
+
+	if ( fd < 0 )
+		return 4;
+
+	n_transfers++;
+
+	if ( use_smbus )
+		return smbus_transfer( addr, wp, wn, rp, rn );
+
+	if ( wn || !rn )
+	{
+		msg[ n ].addr	= addr;
+		msg[ n ].flags	= 0;
+		msg[ n ].len	= wn;
+		msg[ n ].buf	= (uint8_t *)wp;
+		n++;
+	}
+	
+	if ( rn )
+	{
+		msg[ n ].addr	= addr;
+		msg[ n ].flags	= I2C_M_RD;
+		msg[ n ].len	= rn;
+		msg[ n ].buf	= rp;
+		n++;
+	}
+
+	data.msgs	= msg;
+	data.nmsgs	= n;
+
+	if ( sys_ioctl( I2C_RDWR, &data ) < 0 )
+		return ( errno == ENXIO || errno == EREMOTEIO ) ? 2 : 4;
+
+	return 0;
+}
+
+int host_i2c_dev::smbus_call( uint8_t read_write, uint8_t command, int size, union i2c_smbus_data *data )
+{
+	struct i2c_smbus_ioctl_data	args;
+
+	args.read_write	= read_write;
+	args.command	= command;
+	args.size		= size;
+	args.data		= data;
+
+	if ( sys_ioctl( I2C_SMBUS, &args ) < 0 )
+		return ( errno == ENXIO || errno == EREMOTEIO ) ? 2 : 4;
+
+	return 0;
+}
+
+int host_i2c_dev::smbus_transfer( uint8_t addr, const uint8_t *wp, int wn, uint8_t *rp, int rn )
+{
+	union i2c_smbus_data	d;
+	int						rtn;
+
+	if ( rn && (wn > 1) )
+		return 4;	//	not possible in SMBus transfer
+
+	if ( slave_addr != addr )
+	{
+		if ( sys_ioctl( force_addr ? I2C_SLAVE_FORCE : I2C_SLAVE, (void *)(uintptr_t)addr ) < 0 )
+		{
+			if ( errno == EBUSY )
+				fprintf( stderr, "host_i2c_dev: address 0x%02X is used by a kernel driver. Unbind it or use force()\n", addr );
+
+			return 4;
+		}
+
+		slave_addr	= addr;
+	}
+
+	if ( !wn && !rn )
+		return smbus_call( I2C_SMBUS_WRITE, 0, I2C_SMBUS_QUICK, NULL );
+
+	if ( !wn )
+	{
+		//	read from current register address
+		for ( int i = 0; i < rn; i++ )
+		{
+			if ( (rtn = smbus_call( I2C_SMBUS_READ, 0, I2C_SMBUS_BYTE, &d )) )
+				return rtn;
+
+			rp[ i ]	= d.byte;
+		}
+
+		return 0;
+	}
+
+	if ( (wn == 1) && !rn )
+		return smbus_call( I2C_SMBUS_WRITE, wp[ 0 ], I2C_SMBUS_BYTE, NULL );	//	register address only
+
+	//	I2C block transfers of 32 bytes at most. Register address is incremented for each block
+
+	const uint8_t	*src	= rn ? NULL : wp + 1;
+	int				size	= rn ? rn : wn - 1;
+
+	for ( int i = 0; i < size; i += I2C_SMBUS_BLOCK_MAX )
+	{
+		int	n	= ( size - i < I2C_SMBUS_BLOCK_MAX ) ? size - i : I2C_SMBUS_BLOCK_MAX;
+
+		d.block[ 0 ]	= n;
+
+		if ( src )
+			memcpy( d.block + 1, src + i, n );
+
+		if ( (rtn = smbus_call( rn ? I2C_SMBUS_READ : I2C_SMBUS_WRITE, (uint8_t)(wp[ 0 ] + i), I2C_SMBUS_I2C_BLOCK_DATA, &d )) )
+			return rtn;
+
+		if ( rn )
+			memcpy( rp + i, d.block + 1, n );
+	}
+
+	return 0;
+}
+
+bool host_i2c_dev::smbus( void )
+{
+	return use_smbus;
+}
+
+void host_i2c_dev::force( bool enable )
+{
+	force_addr	= enable;
+	slave_addr	= -1;
+}
+
+unsigned long host_i2c_dev::transfers( void )
+{
+	return n_transfers;
+}
+
+unsigned long host_i2c_dev::syscalls( void )
+{
+	return n_syscalls;
+}
+
+void host_i2c_dev::clear_counts( void )
+{
+	n_transfers	= 0;
+	n_syscalls	= 0;
+}
+
+fake_i2c_dev::fake_i2c_dev( bool smbus_only ) : smbus_only( smbus_only ), current_addr( -1 )
+{
+	memset( present, 0, sizeof( present ) );
+	memset( reg_ptr, 0, sizeof( reg_ptr ) );
+	memset( reg_last, 0xFF, sizeof( reg_last ) );
+}
+
+fake_i2c_dev::~fake_i2c_dev()
+{
+}
+
+bool fake_i2c_dev::open( const char *path )
+{
+	close();
+
+	if ( (fd = ::open( path, O_RDWR | O_CREAT, 0644 )) < 0 )
+		return false;
+
+	if ( ftruncate( fd, 128 * 256 ) < 0 )
+	{
+		close();
+		return false;
+	}
+
+	use_smbus	= smbus_only;
+	return true;
+}
+
+void fake_i2c_dev::enable( uint8_t addr )
+{
+	present[ addr & 0x7F ]	= true;
+}
+
+void fake_i2c_dev::wrap( uint8_t addr, uint8_t last )
+{
+	reg_last[ addr & 0x7F ]	= last;
+}
+
+int fake_i2c_dev::reg_access( uint8_t addr, uint8_t *data, int size, bool read )
+{
+	for ( int i = 0; i < size; i++ )
+	{
+		off_t	offset	= addr * 256 + reg_ptr[ addr ];
+		int		r		= read ? pread( fd, data + i, 1, offset ) : pwrite( fd, data + i, 1, offset );
+
+		if ( r != 1 )
+			return -1;
+
+		reg_ptr[ addr ]	= ( reg_ptr[ addr ] == reg_last[ addr ] ) ? 0 : reg_ptr[ addr ] + 1;
+	}
+
+	return 0;
+}
+
+int fake_i2c_dev::do_ioctl( unsigned long request, void *arg )
+{
+	switch ( request )
+	{
+		case I2C_FUNCS :
+			*(unsigned long *)arg	= I2C_FUNC_SMBUS_QUICK | I2C_FUNC_SMBUS_BYTE | I2C_FUNC_SMBUS_I2C_BLOCK | (smbus_only ? 0 : I2C_FUNC_I2C);
+			return 0;
+
+		case I2C_SLAVE :
+		case I2C_SLAVE_FORCE :
+			current_addr	= (int)(uintptr_t)arg & 0x7F;
+			return 0;
+
+		case I2C_RDWR :
+		{
+			struct i2c_rdwr_ioctl_data	*d	= (struct i2c_rdwr_ioctl_data *)arg;
+
+			if ( smbus_only )
+				break;
+
+			for ( unsigned int i = 0; i < d->nmsgs; i++ )
+			{
+				struct i2c_msg	*m		= d->msgs + i;
+				uint8_t			addr	= m->addr & 0x7F;
+				
+				if ( !present[ addr ] )
+				{
+					errno	= ENXIO;
+					return -1;
+				}
+
+				if ( m->flags & I2C_M_RD )
+				{
+					if ( reg_access( addr, m->buf, m->len, true ) )
+						return -1;
+				}
+				else if ( m->len )
+				{
+					reg_ptr[ addr ]	= m->buf[ 0 ];
+					
+					if ( reg_access( addr, m->buf + 1, m->len - 1, false ) )
+						return -1;
+				}
+			}
+			return d->nmsgs;
+		}
+
+		case I2C_SMBUS :
+		{
+			struct i2c_smbus_ioctl_data	*a	= (struct i2c_smbus_ioctl_data *)arg;
+
+			if ( (current_addr < 0) || !present[ current_addr ] )
+			{
+				errno	= ENXIO;
+				return -1;
+			}
+			
+			if ( a->size == I2C_SMBUS_QUICK )
+				return 0;
+			
+			if ( a->size == I2C_SMBUS_BYTE )
+			{
+				if ( a->read_write == I2C_SMBUS_READ )
+					return reg_access( current_addr, &a->data->byte, 1, true );
+
+				reg_ptr[ current_addr ]	= a->command;
+				return 0;
+			}
+			
+			if ( (a->size != I2C_SMBUS_I2C_BLOCK_DATA) || (I2C_SMBUS_BLOCK_MAX < a->data->block[ 0 ]) )
+				break;
+
+			reg_ptr[ current_addr ]	= a->command;
+			
+			return reg_access( current_addr, a->data->block + 1, a->data->block[ 0 ], a->read_write == I2C_SMBUS_READ );
+		}
+	}
+
+	errno	= EINVAL;
+	return -1;
+}
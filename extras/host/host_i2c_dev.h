@@ -0,0 +1,136 @@
+/** Linux i2c-dev backend for host build of RTC_NXP_Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef RTC_NXP_HOST_I2C_DEV_H
+#define RTC_NXP_HOST_I2C_DEV_H
+
+#include <host_bus.h>
+
+union i2c_smbus_data;
+
+/** host_i2c_dev class
+ *	
+ *	TwoWire backend on /dev/i2c-N. 
+ *	A transfer (write, repeated-START, read) is done by one I2C_RDWR ioctl. 
+ *	On adapters without plain I2C support (e.g. i2c-stub), SMBus transfers are used 
+ *	(I2C_SLAVE ioctl on address change). Longer accesses are split into 32 byte I2C block transfers. 
+ *	Read without register address is done by SMBus receive byte for each byte. 
+ *	I2C_SLAVE fails with EBUSY if a kernel driver (e.g. rtc-pcf85063) is bound to the address. 
+ *	The driver can be unbound, or force() makes it use I2C_SLAVE_FORCE. 
+ *
+ *	Usage:
+ *	  host_i2c_dev	i2c;
+ *	  i2c.open( "/dev/i2c-1" );
+ *	  Wire.bus( &i2c );
+ *
+ *  @class host_i2c_dev
+ */
+
+class host_i2c_dev : public host_i2c_bus
+{
+public:
+	host_i2c_dev();
+	virtual ~host_i2c_dev();
+
+	/** Open device
+	 *
+	 * @param path device path like "/dev/i2c-1"
+	 * @return true if success
+	 */
+	virtual bool open( const char *path );
+
+	/** Close device */
+	virtual void close( void );
+
+	int		i2c_transfer( uint8_t addr, const uint8_t *wp, int wn, uint8_t *rp, int rn );
+
+	/** Adapter works with SMBus transfers */
+	bool	smbus( void );
+
+	/** Access addresses used by kernel drivers (I2C_SLAVE_FORCE) in SMBus transfers
+	 *
+	 * @param enable true to use I2C_SLAVE_FORCE
+	 */
+	void	force( bool enable );
+
+	/** Number of transfers */
+	unsigned long	transfers( void );
+
+	/** Number of ioctl system calls */
+	unsigned long	syscalls( void );
+
+	/** Clear counters */
+	void	clear_counts( void );
+
+protected:
+	/** ioctl on the device. Overridden by fake. Counted as a system call */
+	virtual int		do_ioctl( unsigned long request, void *arg );
+
+	int				fd;
+	bool			use_smbus;
+
+private:
+	int				sys_ioctl( unsigned long request, void *arg );
+	int				smbus_transfer( uint8_t addr, const uint8_t *wp, int wn, uint8_t *rp, int rn );
+	int				smbus_call( uint8_t read_write, uint8_t command, int size, union i2c_smbus_data *data );
+
+	int				slave_addr;
+	bool			force_addr;
+	unsigned long	n_transfers;
+	unsigned long	n_syscalls;
+};
+
+/** fake_i2c_dev class
+ *	
+ *	host_i2c_dev with ioctl emulation on register files stored in a regular file. 
+ *	Each 7 bit address has 256 registers at offset (address * 256) of the file. 
+ *	Register contents are kept over runs, so it can be used as persistent fake device. 
+ *
+ *  @class fake_i2c_dev
+ */
+
+class fake_i2c_dev : public host_i2c_dev
+{
+public:
+	/** Create a fake_i2c_dev instance
+	 *
+	 * @param smbus_only if true, work like an adapter which supports SMBus only
+	 */
+	fake_i2c_dev( bool smbus_only = false );
+	virtual ~fake_i2c_dev();
+
+	/** Open register file (created if not exist)
+	 *
+	 * @param path file path
+	 * @return true if success
+	 */
+	bool	open( const char *path );
+
+	/** Enable an address (all addresses NACK until enabled) */
+	void	enable( uint8_t addr );
+
+	/** Register address wrap-around of an I2C target (same as fake_register_bus::wrap())
+	 *
+	 * @param addr 7 bit target address
+	 * @param last last register. Auto-increment goes to register 0 after this (default: 0xFF)
+	 */
+	void	wrap( uint8_t addr, uint8_t last );
+
+protected:
+	int		do_ioctl( unsigned long request, void *arg );
+
+private:
+	int		reg_access( uint8_t addr, uint8_t *data, int size, bool read );
+
+	bool	smbus_only;
+	bool	present[ 128 ];
+	uint8_t	reg_ptr[ 128 ];
+	uint8_t	reg_last[ 128 ];
+	int		current_addr;
+};
+
+#endif //	RTC_NXP_HOST_I2C_DEV_H
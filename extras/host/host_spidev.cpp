@@ -0,0 +1,202 @@
+#include <host_spidev.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+
+host_spidev::host_spidev() : fd( -1 ), n_messages( 0 ), n_syscalls( 0 )
+{
+}
+
+host_spidev::~host_spidev()
+{
+	close();
+}
+
+bool host_spidev::open( const char *path, uint32_t speed_hz, uint8_t mode )
+{
+	close();
+
+	if ( (fd = ::open( path, O_RDWR )) < 0 )
+		return false;
+
+	if ( (sys_ioctl( SPI_IOC_WR_MODE, &mode ) < 0) || (sys_ioctl( SPI_IOC_WR_MAX_SPEED_HZ, &speed_hz ) < 0) )
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void host_spidev::close( void )
+{
+	if ( fd >= 0 )
+		::close( fd );
+
+	fd	= -1;
+}
+
+int host_spidev::sys_ioctl( unsigned long request, void *arg )
+{
+	n_syscalls++;
+	return do_ioctl( request, arg );
+}
+
+int host_spidev::do_ioctl( unsigned long request, void *arg )
+{
+	return ioctl( fd, request, arg );
+}
+
+void host_spidev::spi_transfer( uint8_t *data, int size )
+{
+	host_spi_segment	seg	= { data, data, size };
+
+	spi_message( &seg, 1 );
+}
+
+void host_spidev::spi_message( const host_spi_segment *seg, int count )
+{
+	struct spi_ioc_transfer	xfer[ count ];
+
+	memset( xfer, 0, sizeof( xfer ) );
+
+	for ( int i = 0; i < count; i++ )
+	{
+		xfer[ i ].tx_buf	= (uintptr_t)seg[ i ].tx;
+		xfer[ i ].rx_buf	= (uintptr_t)seg[ i ].rx;
+		xfer[ i ].len		= seg[ i ].size;
+	}
+
+	n_messages++;
+
+	if ( (fd < 0) || (sys_ioctl( SPI_IOC_MESSAGE( count ), xfer ) < 0) )
+	{
+		for ( int i = 0; i < count; i++ )
+			if ( seg[ i ].rx )
+				memset( seg[ i ].rx, 0xFF, seg[ i ].size );
+	}
+}
+
+unsigned long host_spidev::messages( void )
+{
+	return n_messages;
+}
+
+unsigned long host_spidev::syscalls( void )
+{
+	return n_syscalls;
+}
+
+void host_spidev::clear_counts( void )
+{
+	n_messages	= 0;
+	n_syscalls	= 0;
+}
+
+fake_spidev::fake_spidev() : spi_mode( 0 ), max_speed( 0 ), n_last( 0 )
+{
+	memset( reg, 0, sizeof( reg ) );
+}
+
+fake_spidev::~fake_spidev()
+{
+	close();
+}
+
+bool fake_spidev::open( const char *path, uint32_t speed_hz, uint8_t mode )
+{
+	(void)path;
+
+	fd	= 0;	//	no file is used. Marked as opened
+
+	if ( (sys_ioctl( SPI_IOC_WR_MODE, &mode ) < 0) || (sys_ioctl( SPI_IOC_WR_MAX_SPEED_HZ, &speed_hz ) < 0) )
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void fake_spidev::close( void )
+{
+	fd	= -1;
+}
+
+uint8_t *fake_spidev::regs( void )
+{
+	return reg;
+}
+
+int fake_spidev::last_segments( void )
+{
+	return n_last;
+}
+
+int fake_spidev::do_ioctl( unsigned long request, void *arg )
+{
+	switch ( request )
+	{
+		case SPI_IOC_WR_MODE :
+			spi_mode	= *(uint8_t *)arg;
+			return 0;
+
+		case SPI_IOC_WR_MAX_SPEED_HZ :
+			max_speed	= *(uint32_t *)arg;
+			return 0;
+	}
+
+	if ( (_IOC_TYPE( request ) != SPI_IOC_MAGIC) || (_IOC_NR( request ) != 0) || (_IOC_DIR( request ) != _IOC_WRITE) )
+	{
+		errno	= EINVAL;
+		return -1;
+	}
+
+	//	SPI_IOC_MESSAGE( N ): byte stream over the transfers in one chip-select period
+
+	struct spi_ioc_transfer	*xfer	= (struct spi_ioc_transfer *)arg;
+	int						count	= _IOC_SIZE( request ) / sizeof( struct spi_ioc_transfer );
+	bool					first	= true;
+	bool					read	= false;
+	uint8_t					ptr		= 0;
+	int						total	= 0;
+
+	for ( int i = 0; i < count; i++ )
+	{
+		const uint8_t	*tx	= (const uint8_t *)(uintptr_t)xfer[ i ].tx_buf;
+		uint8_t			*rx	= (uint8_t *)(uintptr_t)xfer[ i ].rx_buf;
+
+		for ( unsigned int j = 0; j < xfer[ i ].len; j++ )
+		{
+			uint8_t	out	= tx ? tx[ j ] : 0x00;
+			uint8_t	in	= 0xFF;
+
+			if ( first )
+			{
+				read	= out & 0x80;
+				ptr		= out & 0x7F;
+				first	= false;
+			}
+			else
+			{
+				if ( read )
+					in	= reg[ ptr ];
+				else
+					reg[ ptr ]	= out;
+
+				ptr	= (ptr + 1) & 0x7F;
+			}
+
+			if ( rx )
+				rx[ j ]	= in;
+		}
+
+		total	+= xfer[ i ].len;
+	}
+
+	n_last	= count;
+	return total;
+}
@@ -0,0 +1,111 @@
+/** Linux spidev backend for host build of RTC_NXP_Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef RTC_NXP_HOST_SPIDEV_H
+#define RTC_NXP_HOST_SPIDEV_H
+
+#include <host_bus.h>
+
+/** host_spidev class
+ *	
+ *	SPIClass backend on /dev/spidevX.Y. 
+ *	A message (segments in a chip-select period) is done by one SPI_IOC_MESSAGE ioctl. 
+ *	Each segment is given to the kernel as a spi_ioc_transfer pointing the caller's buffers, 
+ *	so a register access (address and data) is transferred without copy in user space. 
+ *	Chip select is driven by the spidev driver. SS pin on host is used to frame the message only. 
+ *
+ *	Usage:
+ *	  host_spidev	spi;
+ *	  spi.open( "/dev/spidev0.0" );
+ *	  SPI.bus( &spi );
+ *
+ *  @class host_spidev
+ */
+
+class host_spidev : public host_spi_bus
+{
+public:
+	host_spidev();
+	virtual ~host_spidev();
+
+	/** Open device
+	 *
+	 * @param path device path like "/dev/spidev0.0"
+	 * @param speed_hz maximum SCK frequency
+	 * @param mode SPI mode (SPI_MODE0 .. SPI_MODE3)
+	 * @return true if success
+	 */
+	virtual bool open( const char *path, uint32_t speed_hz = 1000000, uint8_t mode = 0 );
+
+	/** Close device */
+	virtual void close( void );
+
+	void	spi_transfer( uint8_t *data, int size );
+	void	spi_message( const host_spi_segment *seg, int count );
+
+	/** Number of messages */
+	unsigned long	messages( void );
+
+	/** Number of ioctl system calls */
+	unsigned long	syscalls( void );
+
+	/** Clear counters */
+	void	clear_counts( void );
+
+protected:
+	/** ioctl on the device. Overridden by fake. Counted as a system call */
+	virtual int		do_ioctl( unsigned long request, void *arg );
+
+	/** ioctl with counting */
+	int				sys_ioctl( unsigned long request, void *arg );
+
+	int				fd;
+
+private:
+	unsigned long	n_messages;
+	unsigned long	n_syscalls;
+};
+
+/** fake_spidev class
+ *	
+ *	host_spidev with in-process ioctl emulation of a SPI register target. 
+ *	The target takes register address in bit 6..0 of first byte and read flag in bit 7 (as PCF2131). 
+ *	NULL tx buffer is sent as 0x00 like spidev. 
+ *
+ *  @class fake_spidev
+ */
+
+class fake_spidev : public host_spidev
+{
+public:
+	fake_spidev();
+	virtual ~fake_spidev();
+
+	/** Open fake device. The path is not used */
+	bool	open( const char *path, uint32_t speed_hz = 1000000, uint8_t mode = 0 );
+	void	close( void );
+
+	/** Register content
+	 *
+	 * @return pointer to 128 bytes register file
+	 */
+	uint8_t	*regs( void );
+
+	/** Number of segments in last message */
+	int		last_segments( void );
+
+protected:
+	int		do_ioctl( unsigned long request, void *arg );
+
+private:
+	uint8_t		reg[ 128 ];
+	uint8_t		spi_mode;
+	uint32_t	max_speed;
+	int			n_last;
+};
+
+#endif //	RTC_NXP_HOST_SPIDEV_H
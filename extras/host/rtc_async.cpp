@@ -0,0 +1,353 @@
+#include <rtc_async.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+#include <utility>
+#include <array>
+
+rtc_event_loop::rtc_event_loop() : pending( 0 ), stopping( false ), quit( false ), n_jobs( 0 )
+{
+	struct epoll_event	ev	= {};
+
+	epfd	= epoll_create1( EPOLL_CLOEXEC );
+	evfd	= eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+
+	ev.events	= EPOLLIN;
+	ev.data.fd	= evfd;
+	epoll_ctl( epfd, EPOLL_CTL_ADD, evfd, &ev );
+
+	bus_thread	= std::thread( &rtc_event_loop::bus_thread_main, this );
+}
+
+rtc_event_loop::~rtc_event_loop()
+{
+	{
+		std::lock_guard<std::mutex>	guard( jobs_lock );
+		quit	= true;
+	}
+	jobs_cv.notify_one();
+	bus_thread.join();
+
+	::close( evfd );
+	::close( epfd );
+}
+
+void rtc_event_loop::run( void )
+{
+	stopping	= false;
+
+	while ( !stopping )
+	{
+		std::deque<std::function<void()>>	ready;
+
+		{
+			std::lock_guard<std::mutex>	guard( queue_lock );
+			ready.swap( queue );
+		}
+
+		for ( auto& fn : ready )
+			fn();
+
+		{
+			std::lock_guard<std::mutex>	guard( queue_lock );
+
+			if ( !queue.empty() )
+				continue;
+
+			if ( !pending && watchers.empty() )
+				break;
+		}
+
+		struct epoll_event	ev[ 8 ];
+		int					n	= epoll_wait( epfd, ev, 8, -1 );
+
+		for ( int i = 0; i < n; i++ )
+		{
+			int	fd	= ev[ i ].data.fd;
+
+			if ( fd == evfd )
+			{
+				uint64_t	v;
+
+				if ( read( evfd, &v, sizeof( v ) ) < 0 )
+					continue;	//	spurious wakeup
+
+				continue;
+			}
+
+			auto	it	= watchers.find( fd );
+
+			if ( it == watchers.end() )
+				continue;
+
+			std::function<void()>	fn	= std::move( it->second );
+
+			watchers.erase( it );
+			epoll_ctl( epfd, EPOLL_CTL_DEL, fd, NULL );
+			fn();
+		}
+	}
+}
+
+void rtc_event_loop::stop( void )
+{
+	post( [ this ]{ stopping = true; } );
+}
+
+void rtc_event_loop::wakeup( void )
+{
+	uint64_t	v	= 1;
+
+	if ( write( evfd, &v, sizeof( v ) ) < 0 )
+		return;	//	counter is saturated, loop is woken up anyway
+}
+
+void rtc_event_loop::post( std::function<void()> fn )
+{
+	{
+		std::lock_guard<std::mutex>	guard( queue_lock );
+		queue.push_back( std::move( fn ) );
+	}
+	wakeup();
+}
+
+void rtc_event_loop::watch( int fd, std::function<void()> fn )
+{
+	struct epoll_event	ev	= {};
+
+	ev.events	= EPOLLIN;
+	ev.data.fd	= fd;
+
+	watchers[ fd ]	= std::move( fn );
+	epoll_ctl( epfd, EPOLL_CTL_ADD, fd, &ev );
+}
+
+void rtc_event_loop::add_pending( void )
+{
+	pending++;
+}
+
+void rtc_event_loop::post_pending( std::function<void()> fn )
+{
+	post( [ this, fn ]{ pending--; fn(); } );
+}
+
+void rtc_event_loop::offload( std::function<void()> job, std::function<void()> done )
+{
+	add_pending();
+
+	{
+		std::lock_guard<std::mutex>	guard( jobs_lock );
+
+		jobs.push_back( [ this, job, done ]{ job(); post_pending( done ); } );
+	}
+	jobs_cv.notify_one();
+}
+
+void rtc_event_loop::bus_thread_main( void )
+{
+	for ( ;; )
+	{
+		std::function<void()>	job;
+
+		{
+			std::unique_lock<std::mutex>	guard( jobs_lock );
+
+			jobs_cv.wait( guard, [ this ]{ return quit || !jobs.empty(); } );
+
+			if ( jobs.empty() )
+				return;
+
+			job	= std::move( jobs.front() );
+			jobs.pop_front();
+			n_jobs++;
+		}
+
+		job();
+	}
+}
+
+unsigned long rtc_event_loop::bus_jobs( void )
+{
+	std::lock_guard<std::mutex>	guard( jobs_lock );
+
+	return n_jobs;
+}
+
+gpio_line_int::gpio_line_int() : fd( -1 ), n_events( 0 )
+{
+}
+
+gpio_line_int::~gpio_line_int()
+{
+	close();
+}
+
+bool gpio_line_int::open( const char *chip, unsigned int offset, bool falling )
+{
+	struct gpio_v2_line_request	req;
+	int							cfd;
+
+	close();
+
+	if ( (cfd = ::open( chip, O_RDONLY | O_CLOEXEC )) < 0 )
+		return false;
+
+	memset( &req, 0, sizeof( req ) );
+	req.offsets[ 0 ]	= offset;
+	req.num_lines		= 1;
+	req.config.flags	= GPIO_V2_LINE_FLAG_INPUT | (falling ? GPIO_V2_LINE_FLAG_EDGE_FALLING : GPIO_V2_LINE_FLAG_EDGE_RISING);
+	strncpy( req.consumer, "RTC_NXP INT", sizeof( req.consumer ) - 1 );
+
+	if ( ioctl( cfd, GPIO_V2_GET_LINE_IOCTL, &req ) < 0 )
+	{
+		::close( cfd );
+		return false;
+	}
+
+	::close( cfd );
+	fd	= req.fd;
+
+	return true;
+}
+
+void gpio_line_int::close( void )
+{
+	if ( fd >= 0 )
+		::close( fd );
+
+	fd	= -1;
+}
+
+void gpio_line_int::arm( rtc_event_loop& loop, std::function<void()> fn )
+{
+	loop.watch( fd, [ this, fn ]{
+		struct gpio_v2_line_event	ev;
+
+		if ( read( fd, &ev, sizeof( ev ) ) == sizeof( ev ) )
+			n_events++;
+
+		fn();
+	} );
+}
+
+unsigned long gpio_line_int::events( void )
+{
+	return n_events;
+}
+
+//	ISRs on host are functions without argument. Trampolines are made for each pin
+
+static fake_pin_int	*fake_pins[ HOST_NUM_PINS ];
+
+template <int PIN>
+static void fake_pin_isr( void )
+{
+	if ( fake_pins[ PIN ] )
+		fake_pins[ PIN ]->edge();
+}
+
+template <int... PINS>
+static constexpr std::array<void (*)( void ), sizeof...( PINS )> make_isrs( std::integer_sequence<int, PINS...> )
+{
+	return { fake_pin_isr<PINS>... };
+}
+
+static constexpr auto	fake_pin_isrs	= make_isrs( std::make_integer_sequence<int, HOST_NUM_PINS>() );
+
+fake_pin_int::fake_pin_int( uint8_t pin ) : pin( pin ), loop_p( nullptr ), latched( false ), n_events( 0 )
+{
+	fake_pins[ pin ]	= this;
+
+	pinMode( pin, INPUT_PULLUP );
+	attachInterrupt( digitalPinToInterrupt( pin ), fake_pin_isrs[ pin ], FALLING );
+}
+
+fake_pin_int::~fake_pin_int()
+{
+	detachInterrupt( digitalPinToInterrupt( pin ) );
+	fake_pins[ pin ]	= nullptr;
+}
+
+void fake_pin_int::arm( rtc_event_loop& loop, std::function<void()> fn )
+{
+	std::lock_guard<std::mutex>	guard( lock );
+
+	loop.add_pending();
+
+	if ( latched )
+	{
+		latched	= false;
+		loop.post_pending( fn );
+		return;
+	}
+
+	loop_p	= &loop;
+	waiter	= fn;
+}
+
+void fake_pin_int::edge( void )
+{
+	std::lock_guard<std::mutex>	guard( lock );
+
+	n_events++;
+
+	if ( !waiter )
+	{
+		latched	= true;
+		return;
+	}
+
+	loop_p->post_pending( std::move( waiter ) );
+	waiter	= nullptr;
+}
+
+unsigned long fake_pin_int::events( void )
+{
+	std::lock_guard<std::mutex>	guard( lock );
+
+	return n_events;
+}
+
+rtc_async::rtc_async( RTC_NXP& rtc, rtc_event_loop& loop, rtc_int_source *int_src ) : rtc( rtc ), loop( loop ), int_src( int_src )
+{
+}
+
+rtc_async::~rtc_async()
+{
+}
+
+rtc_bus_op<time_t> rtc_async::rtc_time( void )
+{
+	return rtc_bus_op<time_t>( loop, [ this ]{ return rtc.time( NULL ); } );
+}
+
+rtc_bus_op<void> rtc_async::set( const struct tm& now_tm )
+{
+	return rtc_bus_op<void>( loop, [ this, now_tm ]{ struct tm t = now_tm; rtc.set( &t ); } );
+}
+
+rtc_bus_op<void> rtc_async::alarm( RTC_NXP::alarm_setting digit, int val )
+{
+	return rtc_bus_op<void>( loop, [ this, digit, val ]{ rtc.alarm( digit, val ); } );
+}
+
+rtc_bus_op<uint8_t> rtc_async::int_clear( void )
+{
+	return rtc_bus_op<uint8_t>( loop, [ this ]{ return rtc.int_clear(); } );
+}
+
+rtc_async::int_wait rtc_async::wait_for_interrupt( void )
+{
+	return int_wait( loop, int_src );
+}
+
+RTC_NXP& rtc_async::device( void )
+{
+	return rtc;
+}
@@ -0,0 +1,331 @@
+/** C++20 coroutine API for host build of RTC_NXP_Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *	This file needs C++20 (-std=gnu++20). Rest of the library is C++11.
+ */
+
+#ifndef RTC_NXP_HOST_RTC_ASYNC_H
+#define RTC_NXP_HOST_RTC_ASYNC_H
+
+#include <RTC_NXP.h>
+
+#include <coroutine>
+#include <functional>
+#include <deque>
+#include <map>
+#include <thread>
+#include <condition_variable>
+#include <exception>
+
+/** rtc_event_loop class
+ *	
+ *	Single thread event loop to resume coroutines. 
+ *	Bus accesses are blocking system calls on Linux, so those are done in a bus thread 
+ *	and the coroutine is resumed in the loop thread when the access is completed. 
+ *	Jobs in the bus thread are executed one by one, so accesses to devices on the bus are serialized. 
+ *	Drivers should not be called directly from other threads while the loop is running 
+ *	unless a lock is set by RTC_NXP::bus_lock(). 
+ *
+ *  @class rtc_event_loop
+ */
+
+class rtc_event_loop
+{
+public:
+	rtc_event_loop();
+	virtual ~rtc_event_loop();
+
+	/** Run the loop. Returns when nothing is waiting or stop() is called */
+	void	run( void );
+
+	/** Stop the loop. Thread safe */
+	void	stop( void );
+
+	/** Call a function in the loop thread. Thread safe
+	 *
+	 * @param fn function
+	 */
+	void	post( std::function<void()> fn );
+
+	/** Call a function in the loop thread once when a file descriptor becomes readable
+	 *
+	 * @param fd file descriptor
+	 * @param fn function
+	 */
+	void	watch( int fd, std::function<void()> fn );
+
+	/** Run a blocking job in the bus thread, then call a function in the loop thread
+	 *
+	 * @param job job to be done in the bus thread
+	 * @param done function called in the loop thread after the job
+	 */
+	void	offload( std::function<void()> job, std::function<void()> done );
+
+	/** Tell the loop that an event will be posted by post_pending() later (call in the loop thread) */
+	void	add_pending( void );
+
+	/** Post a function for the event told by add_pending(). Thread safe
+	 *
+	 * @param fn function
+	 */
+	void	post_pending( std::function<void()> fn );
+
+	/** Number of jobs done in the bus thread */
+	unsigned long	bus_jobs( void );
+
+private:
+	void	bus_thread_main( void );
+	void	wakeup( void );
+
+	int										epfd;
+	int										evfd;
+	int										pending;
+	bool									stopping;
+	std::map<int, std::function<void()>>	watchers;
+
+	std::mutex								queue_lock;
+	std::deque<std::function<void()>>		queue;
+
+	std::thread								bus_thread;
+	std::mutex								jobs_lock;
+	std::condition_variable					jobs_cv;
+	std::deque<std::function<void()>>		jobs;
+	bool									quit;
+	unsigned long							n_jobs;
+};
+
+/** rtc_task type
+ *	
+ *	Return type of coroutines started with rtc_event_loop. 
+ *	The coroutine starts immediately and runs until the first co_await. 
+ *	It is detached: no result, frame is freed at the end.
+ */
+
+struct rtc_task
+{
+	struct promise_type
+	{
+		rtc_task			get_return_object( void )	{ return {}; }
+		std::suspend_never	initial_suspend( void ) noexcept	{ return {}; }
+		std::suspend_never	final_suspend( void ) noexcept	{ return {}; }
+		void				return_void( void )	{}
+		void				unhandled_exception( void )	{ std::terminate(); }
+	};
+};
+
+/** rtc_bus_op class
+ *	
+ *	Awaitable of a bus operation. The coroutine is suspended while the operation is done in bus thread
+ */
+
+template <typename T>
+class rtc_bus_op
+{
+public:
+	rtc_bus_op( rtc_event_loop& loop, std::function<T()> fn ) : loop( loop ), fn( fn ) {}
+
+	bool	await_ready( void )	{ return false; }
+	void	await_suspend( std::coroutine_handle<> h )	{ loop.offload( [ this ]{ result = fn(); }, [ h ]{ h.resume(); } ); }
+	T		await_resume( void )	{ return result; }
+
+private:
+	rtc_event_loop&		loop;
+	std::function<T()>	fn;
+	T					result;
+};
+
+template <>
+class rtc_bus_op<void>
+{
+public:
+	rtc_bus_op( rtc_event_loop& loop, std::function<void()> fn ) : loop( loop ), fn( fn ) {}
+
+	bool	await_ready( void )	{ return false; }
+	void	await_suspend( std::coroutine_handle<> h )	{ loop.offload( fn, [ h ]{ h.resume(); } ); }
+	void	await_resume( void )	{}
+
+private:
+	rtc_event_loop&			loop;
+	std::function<void()>	fn;
+};
+
+/** rtc_int_source class
+ *	
+ *	Interface of RTC interrupt (INT pin) sources for wait_for_interrupt()
+ *
+ *  @class rtc_int_source
+ */
+
+class rtc_int_source
+{
+public:
+	virtual ~rtc_int_source() {}
+
+	/** Call a function in the loop thread once on next interrupt
+	 *
+	 * @param loop event loop
+	 * @param fn function
+	 */
+	virtual void	arm( rtc_event_loop& loop, std::function<void()> fn )	= 0;
+};
+
+/** gpio_line_int class
+ *	
+ *	Interrupt source on a GPIO line of Linux gpio character device (/dev/gpiochipN, uAPI v2). 
+ *	Edges are queued by the kernel, so no interrupt is lost while not armed. 
+ *
+ *  @class gpio_line_int
+ */
+
+class gpio_line_int : public rtc_int_source
+{
+public:
+	gpio_line_int();
+	virtual ~gpio_line_int();
+
+	/** Request a line
+	 *
+	 * @param chip device path like "/dev/gpiochip0"
+	 * @param offset line offset in the chip
+	 * @param falling detect falling edge if true (RTC INT is active LOW), rising edge if false
+	 * @return true if success
+	 */
+	bool	open( const char *chip, unsigned int offset, bool falling = true );
+
+	/** Release the line */
+	void	close( void );
+
+	void	arm( rtc_event_loop& loop, std::function<void()> fn );
+
+	/** Number of edges read */
+	unsigned long	events( void );
+
+private:
+	int				fd;
+	unsigned long	n_events;
+};
+
+/** fake_pin_int class
+ *	
+ *	Interrupt source on a host pin driven by host_pin_input() (for fake devices). 
+ *	An interrupt while not armed is latched and given to next arm(). 
+ *
+ *  @class fake_pin_int
+ */
+
+class fake_pin_int : public rtc_int_source
+{
+public:
+	/** Create a fake_pin_int instance
+	 *
+	 * @param pin pin number. Pin is set as INPUT_PULLUP and interrupt on falling edge is attached
+	 */
+	fake_pin_int( uint8_t pin );
+	virtual ~fake_pin_int();
+
+	void	arm( rtc_event_loop& loop, std::function<void()> fn );
+
+	/** Number of edges */
+	unsigned long	events( void );
+
+	/** Called from ISR */
+	void	edge( void );
+
+private:
+	uint8_t					pin;
+	std::mutex				lock;
+	rtc_event_loop			*loop_p;
+	std::function<void()>	waiter;
+	bool					latched;
+	unsigned long			n_events;
+};
+
+/** rtc_async class
+ *	
+ *	Awaitable operations of a RTC for coroutines on rtc_event_loop
+ *
+ *	Usage:
+ *	  rtc_task	service( rtc_async& a ) {
+ *	    for ( ;; ) {
+ *	      co_await a.wait_for_interrupt();
+ *	      co_await a.int_clear();
+ *	      time_t	t	= co_await a.rtc_time();
+ *	    }
+ *	  }
+ *
+ *  @class rtc_async
+ */
+
+class rtc_async
+{
+public:
+	/** Create a rtc_async instance
+	 *
+	 * @param rtc RTC instance
+	 * @param loop event loop
+	 * @param int_src interrupt source for wait_for_interrupt() (default: none)
+	 */
+	rtc_async( RTC_NXP& rtc, rtc_event_loop& loop, rtc_int_source *int_src = nullptr );
+	virtual ~rtc_async();
+
+	/** Awaitable time reading
+	 *
+	 * @return awaitable giving time_t
+	 */
+	rtc_bus_op<time_t>	rtc_time( void );
+
+	/** Awaitable time setting
+	 *
+	 * @param now_tm time to set. Copied, so it need not be kept while suspended
+	 * @return awaitable
+	 */
+	rtc_bus_op<void>	set( const struct tm& now_tm );
+
+	/** Awaitable alarm setting
+	 *
+	 * @param digit SECOND, MINUTE, HOUR, DAY or WEEKDAY
+	 * @param val setting value. 0x80 to disable
+	 * @return awaitable
+	 */
+	rtc_bus_op<void>	alarm( RTC_NXP::alarm_setting digit, int val );
+
+	/** Awaitable interrupt clear
+	 *
+	 * @return awaitable giving the value returned by RTC_NXP::int_clear()
+	 */
+	rtc_bus_op<uint8_t>	int_clear( void );
+
+	/** Awaitable of interrupt */
+	class int_wait
+	{
+	public:
+		int_wait( rtc_event_loop& loop, rtc_int_source *src ) : loop( loop ), src( src ) {}
+
+		bool	await_ready( void )	{ return !src; }
+		void	await_suspend( std::coroutine_handle<> h )	{ src->arm( loop, [ h ]{ h.resume(); } ); }
+		void	await_resume( void )	{}
+
+	private:
+		rtc_event_loop&	loop;
+		rtc_int_source	*src;
+	};
+
+	/** Awaitable interrupt waiting. Resumes immediately if no interrupt source is set
+	 *
+	 * @return awaitable
+	 */
+	int_wait	wait_for_interrupt( void );
+
+	/** RTC instance */
+	RTC_NXP&	device( void );
+
+private:
+	RTC_NXP&		rtc;
+	rtc_event_loop&	loop;
+	rtc_int_source	*int_src;
+};
+
+#endif //	RTC_NXP_HOST_RTC_ASYNC_H
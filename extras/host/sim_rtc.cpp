@@ -0,0 +1,194 @@
+#include <sim_rtc.h>
+#include <RTC_NXP.h>
+#include <math.h>
+#include <chrono>
+
+//	access to BCD conversion of the library, so that the registers are in same format as the driver handles
+
+struct sim_codec : public RTC_NXP
+{
+	using RTC_NXP::epoch2bcd;
+	using RTC_NXP::bcd2epoch;
+	using RTC_NXP::dec2bcd;
+	using RTC_NXP::bcd2dec;
+};
+
+static double host_seconds( void )
+{
+	return std::chrono::duration<double>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+sim_rtc_bus::sim_rtc_bus()
+{
+	memset( chips, 0, sizeof( chips ) );
+}
+
+sim_rtc_bus::~sim_rtc_bus()
+{
+}
+
+void sim_rtc_bus::add( uint8_t addr, chip_type type, double ppm, uint32_t t )
+{
+	chip	&c	= chips[ addr & 0x7F ];
+
+	c.used		= true;
+	c.type		= type;
+	c.stopped	= false;
+	c.ppm		= ppm;
+	c.base_t	= t;
+	c.base_host	= host_seconds();
+
+	switch ( type )
+	{
+		case PCF2131:
+			c.time_reg	= 0x06;	//	100th_Seconds
+			c.time_len	= 8;
+			c.stop_reg	= 0x00;	//	Control_1
+			c.stop_bit	= 0x20;
+			c.last_reg	= 0xFF;
+			break;
+		case PCF85063:
+		case PCF85063TP:
+			c.time_reg	= 0x04;	//	Seconds
+			c.time_len	= 7;
+			c.stop_reg	= 0x00;	//	Control_1
+			c.stop_bit	= 0x20;
+			c.last_reg	= (PCF85063 == type) ? 0x11 : 0x0A;
+
+			if ( PCF85063 == type )
+				memset( regs( addr ) + 0x0B, 0x80, 5 );	//	alarm registers: disabled at reset
+			break;
+		case PCF85263:
+			c.time_reg	= 0x00;	//	100th_seconds
+			c.time_len	= 8;
+			c.stop_reg	= 0x2E;	//	Stop_enable
+			c.stop_bit	= 0x01;
+			c.last_reg	= 0x2F;
+			break;
+	}
+
+	wrap( addr, c.last_reg );
+
+	enable( addr );
+}
+
+void sim_rtc_bus::ppm( uint8_t addr, double ppm )
+{
+	chip	&c	= chips[ addr & 0x7F ];
+	double	now	= host_seconds();
+
+	c.base_t	= chip_time( c, now );
+	c.base_host	= now;
+	c.ppm		= ppm;
+}
+
+double sim_rtc_bus::chip_time( const chip &c, double host )
+{
+	if ( c.stopped )
+		return c.base_t;
+
+	return c.base_t + (host - c.base_host) * (1.0 + c.ppm * 1e-6);
+}
+
+void sim_rtc_bus::store( uint8_t addr, double host )
+{
+	chip		&c	= chips[ addr ];
+	double		t	= chip_time( c, host );
+	uint32_t	s	= (uint32_t)floor( t );
+	uint8_t		bf[ 8 ];
+	uint8_t		*r	= regs( addr ) + c.time_reg;
+
+	sim_codec::epoch2bcd( s, bf );
+	bf[ 0 ]	= sim_codec::dec2bcd( (int)((t - s) * 100.0) % 100 );
+
+	//	PCF85263A counts 100th-seconds only when 100TH (bit 7 of Function, 0x28) is set. It is 0 at reset
+	if ( (PCF85263 == c.type) && !(regs( addr )[ 0x28 ] & 0x80) )
+		bf[ 0 ]	= 0x00;
+
+	//	the oscillator-stop flag (bit 7 of seconds) is kept as it is written
+	bf[ 1 ]	|= r[ (8 == c.time_len) ? 1 : 0 ] & 0x80;
+
+	if ( 7 == c.time_len )
+		memcpy( r, bf + 1, 7 );
+	else
+		memcpy( r, bf, 8 );
+}
+
+double sim_rtc_bus::load( uint8_t addr )
+{
+	chip	&c	= chips[ addr ];
+	uint8_t	bf[ 8 ];
+	uint8_t	*r	= regs( addr ) + c.time_reg;
+
+	if ( 7 == c.time_len )
+	{
+		bf[ 0 ]	= 0;
+		memcpy( bf + 1, r, 7 );
+	}
+	else
+	{
+		memcpy( bf, r, 8 );
+	}
+
+	//	prescaler is cleared by writing: the clock restarts from 0 of 100th-seconds
+	return sim_codec::bcd2epoch( bf );
+}
+
+int sim_rtc_bus::i2c_transfer( uint8_t addr, const uint8_t *wp, int wn, uint8_t *rp, int rn )
+{
+	addr	&= 0x7F;
+
+	chip	&c	= chips[ addr ];
+
+	if ( !c.used )
+		return fake_register_bus::i2c_transfer( addr, wp, wn, rp, rn );
+
+	double	now	= host_seconds();
+
+	store( addr, now );
+
+	int	rtn	= fake_register_bus::i2c_transfer( addr, wp, wn, rp, rn );
+
+	if ( rtn || (wn < 2) )
+		return rtn;
+
+	//	find registers touched by the write, with same wrap-around as the register file
+
+	uint8_t	reg		= wp[ 0 ];
+	bool	time_written	= false;
+	bool	stop_written	= false;
+
+	for ( int i = 1; i < wn; i++ )
+	{
+		if ( (c.time_reg <= reg) && (reg < c.time_reg + c.time_len) )
+			time_written	= true;
+
+		if ( reg == c.stop_reg )
+			stop_written	= true;
+
+		reg	= (reg == c.last_reg) ? 0 : reg + 1;
+	}
+
+	bool	stop	= regs( addr )[ c.stop_reg ] & c.stop_bit;
+
+	if ( stop_written && stop && !c.stopped )
+	{
+		c.base_t	= chip_time( c, now );
+		c.stopped	= true;
+	}
+
+	if ( time_written )
+	{
+		c.base_t	= load( addr );
+		c.base_host	= now;
+	}
+
+	if ( stop_written && !stop && c.stopped )
+	{
+		c.base_t	= floor( c.base_t );
+		c.base_host	= now;
+		c.stopped	= false;
+	}
+
+	return rtn;
+}
@@ -0,0 +1,84 @@
+/** Simulated RTC chips for host build of RTC_NXP_Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef RTC_NXP_HOST_SIM_RTC_H
+#define RTC_NXP_HOST_SIM_RTC_H
+
+#include <host_bus.h>
+
+/** sim_rtc_bus class
+ *
+ *	fake_register_bus with running clocks.
+ *	Time registers of added targets count up with host clock and given frequency error.
+ *	Writing time registers and STOP bit are handled like real chips:
+ *	the clock restarts from the written time with 100th-seconds of 0 when it is written or STOP is released.
+ *	Other registers are plain register file.
+ *
+ *	Usage:
+ *	  sim_rtc_bus	sim;
+ *	  sim.add( 0x53, sim_rtc_bus::PCF2131,  +20.0 );
+ *	  sim.add( 0x51, sim_rtc_bus::PCF85263, -10.0 );
+ *	  Wire.bus( &sim );
+ *
+ *  @class sim_rtc_bus
+ */
+
+class sim_rtc_bus : public fake_register_bus
+{
+public:
+	/** Register layout of simulated chip */
+	enum chip_type {
+		PCF2131,	//	PCF2131 on I2C
+		PCF85063,	//	PCF85063A (no 100th-seconds)
+		PCF85063TP,	//	PCF85063TP (no 100th-seconds and no alarm registers)
+		PCF85263,	//	PCF85263A (100th-seconds counts only while 100TH in Function register is set, 0 at reset)
+	};
+
+	sim_rtc_bus();
+	virtual ~sim_rtc_bus();
+
+	/** Add a simulated chip. The address is enabled
+	 *
+	 * @param addr 7 bit target address
+	 * @param type register layout
+	 * @param ppm frequency error. Positive makes the clock faster
+	 * @param t initial time in seconds since 2000-01-01 00:00:00
+	 */
+	void	add( uint8_t addr, chip_type type, double ppm = 0.0, uint32_t t = 0 );
+
+	/** Change frequency error of a simulated chip
+	 *
+	 * @param addr 7 bit target address
+	 * @param ppm frequency error
+	 */
+	void	ppm( uint8_t addr, double ppm );
+
+	int		i2c_transfer( uint8_t addr, const uint8_t *wp, int wn, uint8_t *rp, int rn );
+
+private:
+	struct chip {
+		bool		used;
+		chip_type	type;
+		uint8_t		time_reg;	//	first time register (100th-seconds or seconds)
+		uint8_t		time_len;
+		uint8_t		stop_reg;
+		uint8_t		stop_bit;
+		uint8_t		last_reg;	//	register address wraps to 0 after this
+		bool		stopped;
+		double		ppm;
+		double		base_t;		//	chip time at base_host
+		double		base_host;	//	host time in seconds
+	};
+
+	double	chip_time( const chip &c, double host );
+	void	store( uint8_t addr, double host );
+	double	load( uint8_t addr );
+
+	chip	chips[ 128 ];
+};
+
+#endif //	RTC_NXP_HOST_SIM_RTC_H
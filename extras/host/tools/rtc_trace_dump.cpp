@@ -0,0 +1,116 @@
+/** rtc_trace_dump: print a bus trace made by RTC_bus_recorder
+ *
+ *	usage: rtc_trace_dump [-s] trace_file
+ *	  -s : summary only
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <RTC_bus_replayer.h>
+
+struct reg_stat {
+	unsigned long	reads;
+	unsigned long	writes;
+};
+
+int main( int argc, char *argv[] )
+{
+	bool				summary_only	= false;
+	const char			*path			= NULL;
+	RTC_trace_reader	trace;
+	RTC_trace_record	r;
+
+	static reg_stat		stat[ 128 ][ 256 ];
+	unsigned long		n_type[ 256 ]	= { 0 };
+	unsigned long		bytes			= 0;
+	uint32_t			max_gap			= 0;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		if ( !strcmp( argv[ i ], "-s" ) )
+			summary_only	= true;
+		else
+			path	= argv[ i ];
+	}
+
+	if ( !path )
+	{
+		fprintf( stderr, "usage: %s [-s] trace_file\n", argv[ 0 ] );
+		return 1;
+	}
+
+	if ( !trace.open( path ) )
+	{
+		fprintf( stderr, "%s: %s\n", path, trace.error() );
+		return 1;
+	}
+
+	while ( trace.next( r ) )
+	{
+		n_type[ r.type ]++;
+		
+		if ( trace.count() > 1 && max_gap < r.delta_us )
+			max_gap	= r.delta_us;
+
+		if ( (r.type == RTC_bus_recorder::REG_READ) || (r.type == RTC_bus_recorder::REG_WRITE) )
+		{
+			reg_stat&	s	= stat[ r.dev & 0x7F ][ r.reg ];
+			
+			if ( r.type == RTC_bus_recorder::REG_READ )
+				s.reads++;
+			else
+				s.writes++;
+		}
+
+		bytes	+= r.size;
+
+		if ( summary_only )
+			continue;
+
+		printf( "%12.6f %c", r.time_us / 1e6, r.type );
+
+		switch ( r.type )
+		{
+			case RTC_bus_recorder::REG_WRITE :
+			case RTC_bus_recorder::REG_READ :
+				printf( " 0x%02X [0x%02X]", r.dev, r.reg );
+				for ( int i = 0; i < r.size; i++ )
+					printf( " %02X", r.data[ i ] );
+				break;
+
+			case RTC_bus_recorder::SPI_TRANSFER :
+				for ( int i = 0; i < r.size; i++ )
+					printf( " %02X", r.data[ i ] );
+				printf( " /" );
+				for ( int i = 0; i < r.size; i++ )
+					printf( " %02X", r.rx[ i ] );
+				break;
+
+			case RTC_bus_recorder::MARKER :
+				printf( " %u", r.reg );
+				break;
+
+			case RTC_bus_recorder::ACCESS_ERROR :
+				printf( " 0x%02X [0x%02X] %c failed, status %u", r.dev, r.reg, r.access, r.status );
+				break;
+		}
+
+		printf( "\n" );
+	}
+
+	if ( trace.error() )
+		fprintf( stderr, "%s: %s (after %lu records)\n", path, trace.error(), trace.count() );
+
+	printf( "\n%lu records in %.6f s: %lu writes, %lu reads, %lu SPI transfers, %lu markers, %lu errors, %lu data bytes, max interval %lu us\n",
+		trace.count(), trace.count() ? r.time_us / 1e6 : 0.0,
+		n_type[ 'W' ], n_type[ 'R' ], n_type[ 'T' ], n_type[ 'M' ], n_type[ 'E' ], bytes, (unsigned long)max_gap );
+
+	for ( int d = 0; d < 128; d++ )
+		for ( int g = 0; g < 256; g++ )
+			if ( stat[ d ][ g ].reads || stat[ d ][ g ].writes )
+				printf( "  device 0x%02X register 0x%02X: %6lu reads, %6lu writes\n", d, g, stat[ d ][ g ].reads, stat[ d ][ g ].writes );
+
+	return trace.error() ? 1 : 0;
+}
@@ -0,0 +1,295 @@
+#include "RTC_NXP.h"
+
+#if RTC_NXP_BUS_STATS
+#define	COUNT( counter )	(counter)++
+#else
+#define	COUNT( counter )	((void)0)
+#endif
+
+static const I2C_for_RTC::retry_policy	default_policy	= { 2, 100, 5000 };
+
+I2C_for_RTC::I2C_for_RTC( uint8_t i2c_address, uint32_t max_clock ) 
+	: I2C_device( i2c_address ), policy( &default_policy ),
+	  max_khz( max_clock / 1000 ), clk_khz( 0 ), auto_fallback( false ), last_status( BUS_OK )
+{
+	init();
+}
+
+I2C_for_RTC::I2C_for_RTC( TwoWire& wire, uint8_t i2c_address, uint32_t max_clock )
+	: I2C_device( wire, i2c_address ), policy( &default_policy ),
+	  max_khz( max_clock / 1000 ), clk_khz( 0 ), auto_fallback( false ), last_status( BUS_OK )
+{
+	init();
+}
+
+void I2C_for_RTC::init( void )
+{
+	clear_errors();
+#if RTC_NXP_BUS_STATS
+	fallback_count	= 0;
+#endif
+	timeout_pending	= true;	//	TwoWire may not be constructed yet: set on first access
+}
+
+I2C_for_RTC::~I2C_for_RTC()
+{
+}
+
+int I2C_for_RTC::reg_w( uint8_t reg_adr, uint8_t *data, uint16_t size )
+{
+	return try_reg_w( reg_adr, data, size ) ? 0 : size;
+}
+
+int I2C_for_RTC::reg_w( uint8_t reg_adr, uint8_t data )
+{
+	return reg_w( reg_adr, &data, 1 );
+}
+
+int I2C_for_RTC::reg_r( uint8_t reg_adr, uint8_t *data, uint16_t size )
+{
+	return try_reg_r( reg_adr, data, size ) ? 0 : size;
+}
+
+uint8_t I2C_for_RTC::reg_r( uint8_t reg_adr )
+{
+	uint8_t	data	= 0;
+	
+	reg_r( reg_adr, &data, 1 );
+	
+	return data;
+}
+
+void I2C_for_RTC::write_r8( uint8_t reg, uint8_t val )
+{
+	reg_w( reg, val );
+}
+
+uint8_t I2C_for_RTC::read_r8( uint8_t reg )
+{
+	return reg_r( reg );
+}
+
+void I2C_for_RTC::bit_op8(  uint8_t reg,  uint8_t mask,  uint8_t value )
+{
+	try_bit_op8( reg, mask, value );
+}
+
+I2C_for_RTC::bus_status I2C_for_RTC::try_reg_w( uint8_t reg_adr, const uint8_t *data, uint16_t size )
+{
+	return access( reg_adr, (uint8_t *)data, size, false );
+}
+
+I2C_for_RTC::bus_status I2C_for_RTC::try_reg_r( uint8_t reg_adr, uint8_t *data, uint16_t size )
+{
+	return access( reg_adr, data, size, true );
+}
+
+I2C_for_RTC::bus_status I2C_for_RTC::try_bit_op8( uint8_t reg, uint8_t mask, uint8_t value )
+{
+	uint8_t		tmp;
+	bus_status	rtn;
+	
+	if ( (rtn = try_reg_r( reg, &tmp, 1 )) )
+		return rtn;
+	
+	tmp	= (tmp & mask) | value;
+
+	return try_reg_w( reg, &tmp, 1 );
+}
+
+void I2C_for_RTC::retry( const retry_policy& p )
+{
+	policy			= &p;
+	timeout_pending	= true;
+}
+
+//	TwoWire timeout bounds a hung bus in single transfer. Set on first access after construction or retry(). 
+//	The timeout is of the TwoWire: last one set is used for all devices on the bus
+
+void I2C_for_RTC::set_timeout( void )
+{
+#ifdef WIRE_HAS_TIMEOUT
+	wire.setWireTimeout( policy->deadline_us, true );
+#endif
+}
+
+I2C_for_RTC::retry_policy I2C_for_RTC::retry( void )
+{
+	return *policy;
+}
+
+I2C_for_RTC::bus_status I2C_for_RTC::status( void )
+{
+	return (bus_status)last_status;
+}
+
+unsigned long I2C_for_RTC::errors( void )
+{
+#if RTC_NXP_BUS_STATS
+	return error_count;
+#else
+	return 0;
+#endif
+}
+
+unsigned long I2C_for_RTC::retries( void )
+{
+#if RTC_NXP_BUS_STATS
+	return retry_count;
+#else
+	return 0;
+#endif
+}
+
+void I2C_for_RTC::clear_errors( void )
+{
+#if RTC_NXP_BUS_STATS
+	error_count	= 0;
+	retry_count	= 0;
+#endif
+}
+
+void I2C_for_RTC::bus_profile( RTC_NXP::bus_speed speed, bool fallback )
+{
+	uint16_t	khz	= (RTC_NXP::BUS_SPEED_STANDARD == speed) ? 100 : (RTC_NXP::BUS_SPEED_FAST == speed) ? 400 : 1000;
+
+	clk_khz			= khz < max_khz ? khz : max_khz;
+	auto_fallback	= fallback;
+
+	wire.setClock( bus_clock() );
+}
+
+uint32_t I2C_for_RTC::bus_clock( void )
+{
+	return clk_khz * 1000UL;
+}
+
+unsigned long I2C_for_RTC::fallbacks( void )
+{
+#if RTC_NXP_BUS_STATS
+	return fallback_count;
+#else
+	return 0;
+#endif
+}
+
+bool I2C_for_RTC::fall_back( void )
+{
+	if ( clk_khz <= 100 )
+		return false;
+
+	clk_khz	= ( clk_khz > 400 ) ? 400 : 100;
+	wire.setClock( bus_clock() );
+	COUNT( fallback_count );
+
+	return true;
+}
+
+I2C_for_RTC::bus_status I2C_for_RTC::access( uint8_t reg_adr, uint8_t *data, uint16_t size, bool read )
+{
+	unsigned long	start	= micros();
+	unsigned long	backoff	= policy->backoff_us;
+	bus_status		rtn;
+	
+	if ( timeout_pending ) {
+		set_timeout();
+		timeout_pending	= false;
+	}
+
+	for ( int i = 0; ; i++ )
+	{
+		rtn	= transfer( reg_adr, data, size, read );
+		
+		if ( RTC_bus_recorder::recording() )
+			record( reg_adr, data, size, read, rtn );
+
+		if ( (rtn == BUS_OK) || (rtn == BUS_DATA_TOO_LONG) || (i >= policy->retries) )
+			break;
+
+		if ( policy->deadline_us < (micros() - start) + backoff )
+		{
+			rtn	= BUS_DEADLINE;
+			break;
+		}
+		
+		RTC_NXP_TRACE_EVENT( "bus_retry", rtn );
+
+		if ( auto_fallback && fall_back() )
+			RTC_NXP_TRACE_EVENT( "bus_fallback", bus_clock() );
+
+		delayMicroseconds( backoff );
+		backoff	<<= 1;
+		COUNT( retry_count );
+	}
+
+	last_status	= rtn;
+	
+	if ( rtn != BUS_OK )
+		COUNT( error_count );
+
+	return rtn;
+}
+
+//	data is recorded only for successful try. Read buffer is not valid on failure
+
+void I2C_for_RTC::record( uint8_t reg_adr, const uint8_t *data, uint16_t size, bool read, bus_status rtn )
+{
+	uint8_t	type	= read ? RTC_bus_recorder::REG_READ : RTC_bus_recorder::REG_WRITE;
+	
+	if ( rtn == BUS_OK )
+		RTC_bus_recorder::reg_access( type, i2c_addr, reg_adr, data, size );
+	else if ( rtn != BUS_DATA_TOO_LONG )	//	nothing was on the bus
+		RTC_bus_recorder::access_error( type, i2c_addr, reg_adr, rtn );
+}
+
+I2C_for_RTC::bus_status I2C_for_RTC::transfer( uint8_t reg_adr, uint8_t *data, uint16_t size, bool read )
+{
+	uint8_t	rtn;
+	
+	//	checked before starting: a truncated write must not be sent to the device
+	
+	if ( RTC_NXP_I2C_BUFFER < (read ? size : size + 1) )
+		return BUS_DATA_TOO_LONG;
+	
+	wire.beginTransmission( i2c_addr );
+	wire.write( reg_adr );
+	
+	if ( !read && (wire.write( data, size ) != size) )
+		return BUS_DATA_TOO_LONG;	//	not sent: buffer is cleared by next beginTransmission()
+	
+	rtn	= wire.endTransmission( !read );
+	
+#ifdef WIRE_HAS_TIMEOUT
+	if ( wire.getWireTimeoutFlag() )
+	{
+		wire.clearWireTimeoutFlag();
+		return BUS_TIMEOUT;
+	}
+#endif
+
+	if ( rtn )
+		return (rtn <= BUS_TIMEOUT) ? (bus_status)rtn : BUS_ERROR;
+
+	if ( !read )
+		return BUS_OK;
+
+	if ( wire.requestFrom( i2c_addr, (uint8_t)size ) != size )
+	{
+#ifdef WIRE_HAS_TIMEOUT
+		if ( wire.getWireTimeoutFlag() )
+		{
+			wire.clearWireTimeoutFlag();
+			return BUS_TIMEOUT;
+		}
+#endif
+		while ( wire.available() )
+			wire.read();
+
+		return BUS_NACK_ADDRESS;	//	requestFrom() returns 0 when target didn't respond
+	}
+
+	for ( uint16_t i = 0; i < size; i++ )
+		data[ i ]	= wire.read();
+
+	return BUS_OK;
+}
@@ -1,6 +1,6 @@
 #include "RTC_NXP.h"
 
-PCF2131_SPI::PCF2131_SPI()
+PCF2131_SPI::PCF2131_SPI() : SPI_for_RTC( 6500000 )
 {
 }
 
@@ -1,6 +1,6 @@
 #include "RTC_NXP.h"
 
-PCF2131_base::PCF2131_base()
+PCF2131_base::PCF2131_base() : ctrl1_hold( 0 )
 {
 }
 
@@ -8,6 +8,16 @@ PCF2131_base::~PCF2131_base()
 {
 }
 
+PCF2131_base::config::config()
+	: periodic( DISABLE ), periodic_int( ROUTE_NONE ), alarm_int( ROUTE_NONE ), watchdog_int( ROUTE_NONE ),
+	  clock_out( FREQ_32768_HZ ), watchdog_ctl( 0x03 ), watchdog_val( 0x00 ), offset( 0x08 )
+{
+	for ( int i = 0; i < 4; i++ ) {
+		ts_int[ i ]		= ROUTE_NONE;
+		ts_mode[ i ]	= LAST;
+	}
+}
+
 void PCF2131_base::begin( void )
 {
 	int_clear();
@@ -16,11 +26,22 @@ void PCF2131_base::begin( void )
 
 bool PCF2131_base::oscillator_stop( void )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	return _reg_r( Seconds ) & 0x80;
 }
 
+bool PCF2131_base::has_hundredths( void )
+{
+	return true;
+}
+
 time_t PCF2131_base::rtc_time()
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	struct tm	now_tm;
 
 	uint8_t		bf[ 8 ];
@@ -40,6 +61,8 @@ time_t PCF2131_base::rtc_time()
 
 void PCF2131_base::set( struct tm* now_tmp )
 {
+	RTC_NXP_TRACE_SCOPE();
+
 	time_t		now_time;
 	struct tm*	cnv_tmp;
 
@@ -57,18 +80,122 @@ void PCF2131_base::set( struct tm* now_tmp )
 	cnv_tmp		= localtime( &now_time );
 	bf[ 5 ]		= dec2bcd( cnv_tmp->tm_wday);
 	
+	{
+		RTC_NXP_GUARD();
+		set_time_regs( bf );
+	}
+
+	settle();	//	other devices on the bus can be accessed while waiting
+}
+
+void PCF2131_base::rtc_time_regs( uint8_t* bf )
+{
+	_reg_r( _100th_Seconds, bf, 8 );
+}
+
+void PCF2131_base::set_time_regs( uint8_t* bf )
+{
+	bf[ 0 ]	= 0;
+	
 	_bit_op8( Control_1, ~0x28, 0x20 );
 	_bit_op8( SR_Reset,  (uint8_t)(~0x80), 0x80 );
 
-	_reg_w( _100th_Seconds, bf, sizeof( bf ) );
+	_reg_w( _100th_Seconds, bf, 8 );
 
 	_bit_op8( Control_1, ~0x20, 0x00 );
+}
+
+//	OTP refresh is done after set_time_regs() and before hold_time_regs() (so that release() can be a single write). 
+//	Caller doesn't hold the bus lock: otp_refresh() takes it only for its register accesses
+
+void PCF2131_base::settle( void )
+{
+	otp_refresh();
+	RTC_NXP_TRACE_EVENT( "otp_refresh_wait", 100 );
+	delay( 100 );	//	OTP refresh will be completed less than 100 ms
+}
+
+bool PCF2131_base::hold_time_regs( uint8_t* bf )
+{
+	bf[ 0 ]		= 0;
+	ctrl1_hold	= (_reg_r( Control_1 ) & ~0x08) | 0x20;
 	
+	_reg_w( Control_1, ctrl1_hold );
+	_bit_op8( SR_Reset,  (uint8_t)(~0x80), 0x80 );
+
+	_reg_w( _100th_Seconds, bf, 8 );
 	
-	//	OTP refresh
+	return true;
+}
+
+void PCF2131_base::release_time_regs( void )
+{
+	_reg_w( Control_1, ctrl1_hold & ~0x20 );
+}
+
+//	value to write a control register without clearing interrupt flags: writing 1 keeps the flag
+
+static uint8_t keep_flags( int reg, uint8_t v )
+{
+	switch ( reg ) {
+		case PCF2131_base::Control_2:	return (v & ~0x49) | 0x90;	//	MSF and AF
+		case PCF2131_base::Control_3:	return v | 0x08;			//	BF
+		case PCF2131_base::Control_4:	return v | 0xF0;			//	TSF1..TSF4
+	}
 	
-	otp_refresh();
-	delay( 100 );	//	OTP refresh will be completed less than 100 ms
+	return v;
+}
+
+//	bursts longer than I2C buffer (41 bytes of Second_alarm..Watchdg_tim_val) are split. 
+//	Register address takes a byte of the buffer in write
+
+#define	BURST_MAX	(RTC_NXP_I2C_BUFFER - 1)
+
+void PCF2131_base::burst_r( uint8_t reg, uint8_t *vp, int len )
+{
+	for ( int i = 0; i < len; i += BURST_MAX )
+		_reg_r( reg + i, vp + i, (BURST_MAX < len - i) ? BURST_MAX : len - i );
+}
+
+void PCF2131_base::burst_w( uint8_t reg, const uint8_t *vp, int len )
+{
+	for ( int i = 0; i < len; i += BURST_MAX )
+		_reg_w( reg + i, (uint8_t*)vp + i, (BURST_MAX < len - i) ? BURST_MAX : len - i );
+}
+
+//	snapshot blob: tag, size, Control_1..Control_5 and Second_alarm..Watchdg_tim_val
+//	SR_Reset and time registers are skipped. Timestamp registers are included as those are in the range
+
+#define	CONFIG_TAG	0x31
+#define	CONFIG_SIZE	(5 + Watchdg_tim_val - Second_alarm + 1)
+
+uint8_t PCF2131_base::save_config( uint8_t* blob )
+{
+	blob[ 0 ]	= CONFIG_TAG;
+	blob[ 1 ]	= CONFIG_SIZE;
+	
+	_reg_r( Control_1, blob + 2, 5 );
+	burst_r( Second_alarm, blob + 7, CONFIG_SIZE - 5 );
+	
+	return CONFIG_SIZE + 2;
+}
+
+bool PCF2131_base::load_config( const uint8_t* blob )
+{
+	if ( (CONFIG_TAG != blob[ 0 ]) || (CONFIG_SIZE != blob[ 1 ]) )
+		return false;
+	
+	uint8_t	v[ 5 ];
+	
+	v[ 0 ]	= blob[ 2 ] & ~0x28;	//	Control_1: STOP cleared, same as set_time_regs()
+
+	for ( int i = 1; i < 5; i++ )
+		v[ i ]	= keep_flags( i, blob[ 2 + i ] );
+
+	_reg_w( Control_1, v, sizeof( v ) );
+	burst_w( Second_alarm, blob + 7, CONFIG_SIZE - 5 );
+	
+	return true;
 }
 
 void PCF2131_base::alarm( alarm_setting digit, int val )
@@ -78,24 +205,55 @@ void PCF2131_base::alarm( alarm_setting digit, int val )
 
 void PCF2131_base::alarm( alarm_setting digit, int val, int int_sel )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	int	v = (val == 0x80) ? 0x80 : dec2bcd( val );
 	_reg_w( Second_alarm + digit, v );
-	_bit_op8( int_mask_reg[ int_sel ][ 0 ], ~0x04, 0x00 );
+	_bit_op8( int_mask_reg( int_sel, 0 ), ~0x04, 0x00 );
 	_bit_op8( Control_2, ~0x02, 0x02 );
 }
 
+void PCF2131_base::alarm_match( uint8_t mask, struct tm* alarm_tm )
+{
+	alarm_match( mask, alarm_tm, 0 );
+}
+
+void PCF2131_base::alarm_match( uint8_t mask, struct tm* alarm_tm, int int_sel )
+{
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	uint8_t	bf[ 5 ];
+	
+	alarm_regs( mask, alarm_tm, bf );
+	
+	_reg_w( Second_alarm, bf, sizeof( bf ) );
+	_bit_op8( int_mask_reg( int_sel, 0 ), ~0x04, 0x00 );
+	_bit_op8( Control_2, ~0x12, 0x02 );	//	AF clear and AIE set
+}
+
 void PCF2131_base::alarm_clear( void )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	_bit_op8( Control_2, ~0x10, 0x00 );	
 }
 
 void PCF2131_base::alarm_disable( void )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	_bit_op8( Control_2, ~0x02, 0x00 );
 }
 
 void PCF2131_base::timestamp( int num, timestamp_setting ts_setting, int int_sel )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	const int r_ofst	= 7;
 	const int fst		= ts_setting ? 0x80 : 0x00;
 	
@@ -104,13 +262,16 @@ void PCF2131_base::timestamp( int num, timestamp_setting ts_setting, int int_sel
 	uint8_t	reg	= Timestp_ctl1 + num * r_ofst;
 
 	_bit_op8( reg, (uint8_t)(~0x80), fst );
-	_bit_op8( int_mask_reg[ int_sel ][ 1 ], ~(0x1 << (3 - num)), (0x0 << (3 - num)) );
+	_bit_op8( int_mask_reg( int_sel, 1 ), ~(0x1 << (3 - num)), (0x0 << (3 - num)) );
 
 	_bit_op8( Control_5, ~(0x1 << (7 - num)), (0x1 << (7 - num)) );
 }
 
 time_t PCF2131_base::timestamp( int num )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	const int r_ofst	= 7;
 
 	num	-=1;
@@ -144,7 +305,11 @@ uint8_t PCF2131_base::int_clear( void )
 
 uint8_t PCF2131_base::int_clear( uint8_t* rv )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	_reg_r( Control_2, rv, 3 );
+	RTC_NXP_TRACE_EVENT( "int_flags", ((uint32_t)rv[ 0 ] << 16) | ((uint32_t)rv[ 1 ] << 8) | rv[ 2 ] );
 
 	if ( rv[ 0 ] & 0x90 )	// if interrupt flag set in Control_2
 		_reg_w( Control_2, rv[ 0 ] & ~((rv[ 0 ] & 0x90) | 0x49) );	// datasheet 7.11.5
@@ -160,31 +325,152 @@ uint8_t PCF2131_base::int_clear( uint8_t* rv )
 
 void PCF2131_base::periodic_interrupt_enable( periodic_int_select sel, int int_sel )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	if ( !sel ) {
 		_bit_op8( Control_1, ~0x03, 0x00 );
-		_bit_op8( int_mask_reg[ int_sel ][ 0 ], ~0x30, 0x30 );
+		_bit_op8( int_mask_reg( int_sel, 0 ), ~0x30, 0x30 );
 		return;
 	}
 	
-	uint8_t v	= (sel == EVERY_MINUTE) ? 0x02 : 0x01;
+	uint8_t v	= (sel == EVERY_MINUTE) ? 0x02 : 0x01;	//	MI or SI
 
-	v=3;
 	_bit_op8( Control_1, ~0x03, v );
-	_bit_op8( int_mask_reg[ int_sel ][ 0 ], ~0x30, ~(v << 4) );
+	_bit_op8( int_mask_reg( int_sel, 0 ), ~0x30, ~(v << 4) & 0x30 );	//	unmask selected one only
+}
+
+//	apply(): register image of Control_1..Control_5 and CLKOUT_ctl..Watchdg_tim_val
+
+#define	IMG_CTRL		5
+#define	IMG_SIZE		(IMG_CTRL + Watchdg_tim_val - CLKOUT_ctl + 1)
+#define	BRIDGE_MAX		2	//	unchanged registers between changes written in same burst, instead of starting another burst
+
+static int img_reg( int i )
+{
+	return (i < IMG_CTRL) ? i : i - IMG_CTRL + PCF2131_base::CLKOUT_ctl;
+}
+
+static int img_index( int reg )
+{
+	return (reg < IMG_CTRL) ? reg : reg - PCF2131_base::CLKOUT_ctl + IMG_CTRL;
+}
+
+//	timestamp time registers are not written even if those are between changed registers
+
+static bool bridgeable( int reg )
+{
+	return (reg < PCF2131_base::Timestp_ctl1) || (PCF2131_base::Aging_offset <= reg) || !((reg - PCF2131_base::Timestp_ctl1) % 7);
+}
+
+int PCF2131_base::apply( const config& cfg )
+{
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	uint8_t	cur[ IMG_SIZE ];
+	uint8_t	img[ IMG_SIZE ];
+	uint8_t	ps	= (EVERY_SECOND == cfg.periodic) ? 0x01 : ((EVERY_MINUTE == cfg.periodic) ? 0x02 : 0x00);
+
+	_reg_r( Control_1, cur, IMG_CTRL );
+	burst_r( CLKOUT_ctl, cur + IMG_CTRL, IMG_SIZE - IMG_CTRL );
+	memcpy( img, cur, sizeof( img ) );
+
+	img[ Control_1 ]	= (img[ Control_1 ] & ~0x03) | ps;
+	img[ Control_2 ]	= (img[ Control_2 ] & ~0x02) | ((ROUTE_NONE != cfg.alarm_int) ? 0x02 : 0x00);
+	img[ Control_5 ]	&= ~0xF0;
+
+	for ( int i = 0; i < 4; i++ ) {
+		uint8_t	&ts_ctl	= img[ img_index( Timestp_ctl1 + i * 7 ) ];
+		
+		ts_ctl	= (ts_ctl & ~0x80) | (cfg.ts_mode[ i ] ? 0x80 : 0x00);
+		
+		if ( ROUTE_NONE != cfg.ts_int[ i ] )
+			img[ Control_5 ]	|= 0x80 >> i;
+	}
+
+	//	each interrupt is unmasked only on its output pin
+
+	for ( int pin = 0; pin < 2; pin++ ) {
+		uint8_t	&mask1	= img[ img_index( int_mask_reg( pin, 0 ) ) ];
+		uint8_t	&mask2	= img[ img_index( int_mask_reg( pin, 1 ) ) ];
+
+		mask1	|= 0x3C;
+		mask2	|= 0x0F;
+
+		if ( pin == cfg.periodic_int )
+			mask1	&= ~(ps << 4);
+		
+		if ( pin == cfg.watchdog_int )
+			mask1	&= ~0x08;
+		
+		if ( pin == cfg.alarm_int )
+			mask1	&= ~0x04;
+		
+		for ( int i = 0; i < 4; i++ )
+			if ( pin == cfg.ts_int[ i ] )
+				mask2	&= ~(0x08 >> i);
+	}
+
+	img[ img_index( CLKOUT_ctl ) ]		= (img[ img_index( CLKOUT_ctl ) ] & ~0x07) | cfg.clock_out;
+	img[ img_index( Aging_offset ) ]	= cfg.offset;
+	img[ img_index( Watchdg_tim_ctl ) ]	= cfg.watchdog_ctl;
+	img[ img_index( Watchdg_tim_val ) ]	= cfg.watchdog_val;
+
+	//	write changed registers. A burst is extended over a few unchanged registers to the next change, 
+	//	up to the size which fits in the I2C buffer
+
+	int	bursts	= 0;
+	
+	for ( int i = 0; i < IMG_SIZE; ) {
+		if ( img[ i ] == cur[ i ] ) {
+			i++;
+			continue;
+		}
+		
+		int	end	= i + 1;	//	next of last register in the burst
+		
+		for ( int j = end; j < IMG_SIZE; j++ ) {
+			if ( (IMG_CTRL == j) || !bridgeable( img_reg( j ) ) || (BRIDGE_MAX < j - end) || (BURST_MAX <= j - i) )
+				break;
+			
+			if ( img[ j ] != cur[ j ] )
+				end	= j + 1;
+		}
+
+		for ( int j = i; j < end; j++ )
+			img[ j ]	= keep_flags( img_reg( j ), img[ j ] );
+		
+		_reg_w( img_reg( i ), img + i, end - i );
+		bursts++;
+		
+		i	= end;
+	}
+	
+	return bursts;
 }
 
 void PCF2131_base::set_clock_out(clock_out_frequency freq)
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
     _bit_op8(CLKOUT_ctl, ~0b00000111, freq);
 }
 
 void PCF2131_base::reset()
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
     _reg_w(SR_Reset, 0b00101100);
 }
 
 void PCF2131_base::otp_refresh()
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
     _bit_op8(CLKOUT_ctl, ~0b00100000, 0b00000000);
     _bit_op8(CLKOUT_ctl, ~0b00100000, 0b00100000);
 }
@@ -1,68 +1,194 @@
 #include "RTC_NXP.h"
 
-PCF85053A::PCF85053A( uint8_t i2c_address ) : I2C_device( i2c_address ){}
-PCF85053A::PCF85053A( TwoWire& wire, uint8_t i2c_address ) : I2C_device( wire, i2c_address ){}
+PCF85053A::PCF85053A( uint8_t i2c_address ) : I2C_for_RTC( i2c_address ){}
+PCF85053A::PCF85053A( TwoWire& wire, uint8_t i2c_address ) : I2C_for_RTC( wire, i2c_address ){}
 PCF85053A::~PCF85053A(){}
 
 void PCF85053A::begin( void ){}
 
 void PCF85053A::set( struct tm* now_tmp )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	time_t		now_time;
 	struct tm*	cnv_tmp;
-	uint8_t		bf[ 10 ];
+	uint8_t		bf[ 8 ];
 	
-	bf[ 0 ]	= dec2bcd( now_tmp->tm_sec  );
-	bf[ 1 ]	= 0xFF;	//	Seconds_alarm clear
+	bf[ 0 ]	= 0;
+	bf[ 1 ]	= dec2bcd( now_tmp->tm_sec  );
 	bf[ 2 ]	= dec2bcd( now_tmp->tm_min  );
-	bf[ 3 ]	= 0xFF;	//	Minutes_alarm clear
-	bf[ 4 ]	= dec2bcd( now_tmp->tm_hour );
-	bf[ 5 ]	= 0xFF;	//	Hours_alarm clear
-	bf[ 7 ]	= dec2bcd( now_tmp->tm_mday );
-	bf[ 8 ]	= dec2bcd( now_tmp->tm_mon + 1 );
-	bf[ 9 ]	= dec2bcd( now_tmp->tm_year - 100 );
+	bf[ 3 ]	= dec2bcd( now_tmp->tm_hour );
+	bf[ 4 ]	= dec2bcd( now_tmp->tm_mday );
+	bf[ 6 ]	= dec2bcd( now_tmp->tm_mon + 1 );
+	bf[ 7 ]	= dec2bcd( now_tmp->tm_year - 100 );
 
 	now_time	= mktime( now_tmp );
 	cnv_tmp		= localtime( &now_time );
-	bf[ 6 ]		= dec2bcd( cnv_tmp->tm_wday );
+	bf[ 5 ]		= dec2bcd( cnv_tmp->tm_wday );
+	
+	set_time_regs( bf );
+}
+
+void PCF85053A::rtc_time_regs( uint8_t* bf )
+{
+	uint8_t		v[ 10 ];
+	
+	reg_r( Seconds, v, sizeof( v ) );
+	
+	bf[ 0 ]	= 0;
+	bf[ 1 ]	= v[ 0 ];
+	bf[ 2 ]	= v[ 2 ];
+	bf[ 3 ]	= v[ 4 ];
+	bf[ 4 ]	= v[ 7 ];
+	bf[ 5 ]	= v[ 6 ];
+	bf[ 6 ]	= v[ 8 ];
+	bf[ 7 ]	= v[ 9 ];
+}
+
+void PCF85053A::set_time_regs( uint8_t* bf )
+{
+	uint8_t		v[ 10 ];
+	
+	v[ 0 ]	= bf[ 1 ];
+	v[ 1 ]	= 0xFF;	//	Seconds_alarm clear
+	v[ 2 ]	= bf[ 2 ];
+	v[ 3 ]	= 0xFF;	//	Minutes_alarm clear
+	v[ 4 ]	= bf[ 3 ];
+	v[ 5 ]	= 0xFF;	//	Hours_alarm clear
+	v[ 6 ]	= bf[ 5 ];
+	v[ 7 ]	= bf[ 4 ];
+	v[ 8 ]	= bf[ 6 ];
+	v[ 9 ]	= bf[ 7 ];
+	
+	reg_w( Seconds, v, sizeof( v ) );
+}
+
+//	snapshot blob: tag, size, Control_Register..Scratchpad and Offset..Access_config
+//	Alarm registers are not included as those are placed between time registers
+
+#define	CONFIG_TAG	0x53
+#define	CONFIG_SIZE	(Scratchpad - Control_Register + 1 + Access_config - Offset + 1)
+
+uint8_t PCF85053A::save_config( uint8_t* blob )
+{
+	const int	n	= Scratchpad - Control_Register + 1;
+
+	blob[ 0 ]	= CONFIG_TAG;
+	blob[ 1 ]	= CONFIG_SIZE;
+	
+	reg_r( Control_Register, blob + 2, n );
+	reg_r( Offset, blob + 2 + n, CONFIG_SIZE - n );
+	
+	return CONFIG_SIZE + 2;
+}
+
+bool PCF85053A::load_config( const uint8_t* blob )
+{
+	if ( (CONFIG_TAG != blob[ 0 ]) || (CONFIG_SIZE != blob[ 1 ]) )
+		return false;
 	
-	reg_w( Seconds, bf, sizeof( bf ) );
+	const int	n	= Scratchpad - Control_Register + 1;
+	uint8_t		v[ n ];
+	
+	memcpy( v, blob + 2, sizeof( v ) );
+	v[ Status_Register - Control_Register ]	= 0xFF;	//	writing 1 keeps flags, same as int_clear()
+
+	reg_w( Control_Register, v, sizeof( v ) );
+	reg_w( Offset, (uint8_t*)blob + 2 + n, CONFIG_SIZE - n );
+	
+	return true;
 }
 
 bool PCF85053A::oscillator_stop( void )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	return reg_r( Status_Register ) & 0x40;
 	bit_op8( Status_Register, ~0x40, 0x40 );
 }
 
 void PCF85053A::alarm( alarm_setting digit, int val )
 {
-	reg_w( alarm_offsets[ digit ], dec2bcd( val ) );
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	reg_w( alarm_reg( digit ), dec2bcd( val ) );
+	bit_op8( Control_Register, ~0x08, 0x08 );
+}
+
+void PCF85053A::alarm_match( uint8_t mask, struct tm* alarm_tm )
+{
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	uint8_t	bf[ 5 ];
+	
+	alarm_regs( mask, alarm_tm, bf );
+	
+	//	alarm registers are placed between time registers. Those cannot be written in a burst
+	for ( int i = SECOND; i <= HOUR; i++ )
+		reg_w( alarm_reg( i ), (bf[ i ] & 0x80) ? 0xFF : bf[ i ] );
+
 	bit_op8( Control_Register, ~0x08, 0x08 );
 }
 
 void PCF85053A::alarm_clear( void )
 {
-	reg_w( alarm_offsets[ SECOND ], 0xFF );
-	reg_w( alarm_offsets[ MINUTE ], 0xFF );
-	reg_w( alarm_offsets[ HOUR   ], 0xFF );
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	reg_w( alarm_reg( SECOND ), 0xFF );
+	reg_w( alarm_reg( MINUTE ), 0xFF );
+	reg_w( alarm_reg( HOUR ), 0xFF );
 }
 
 void PCF85053A::alarm_disable( void )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	bit_op8( Control_Register, ~0x08, 0x00 );
 }
 
 uint8_t PCF85053A::int_clear( void )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	uint8_t	status	= reg_r( Status_Register );
+	RTC_NXP_TRACE_EVENT( "int_flags", status );
 	
 	reg_w( Status_Register, ~(status & 0xF0) );
 	return status;
 }
 
+void PCF85053A::set_clock_out( clock_out_frequency freq )
+{
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	uint8_t	v;
+	
+	switch ( freq ) {
+		case FREQ_32768_HZ:	v	= 0x80;	break;
+		case FREQ_1024_HZ:	v	= 0x81;	break;
+		case FREQ_1_HZ:		v	= 0x83;	break;
+		case FREQ_DISABLE:	v	= 0x00;	break;
+		default:
+			Serial.println("*** This CLKOUT frequency is unsupported on PCF85053A ***");		
+			return;
+	}
+
+	bit_op8( CLKOUT_Control, (uint8_t)(~0x83), v );	//	COE and FD[1:0]
+}
+
 time_t PCF85053A::rtc_time( void )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	struct tm	now_tm;
 	uint8_t		bf[ 10 ];
 	
@@ -78,5 +204,3 @@ time_t PCF85053A::rtc_time( void )
 
    return mktime( &now_tm );
 }
-
-int PCF85053A::alarm_offsets[ 3 ]	= { 1, 3, 5 };
@@ -1,6 +1,6 @@
 #include "RTC_NXP.h"
 
-PCF85063_base::PCF85063_base()
+PCF85063_base::PCF85063_base() : ctrl1_hold( 0 )
 {
 }
 
@@ -14,39 +14,121 @@ void PCF85063_base::begin( void )
 
 void PCF85063_base::set( struct tm* now_tmp )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	time_t		now_time;
 	struct tm*	cnv_tmp;
 
-	uint8_t		bf[ 7 ];
+	uint8_t		bf[ 8 ];
 	
-	bf[ 0 ]	= dec2bcd( now_tmp->tm_sec  );
-	bf[ 1 ]	= dec2bcd( now_tmp->tm_min  );
-	bf[ 2 ]	= dec2bcd( now_tmp->tm_hour );
-	bf[ 3 ]	= dec2bcd( now_tmp->tm_mday );
-	bf[ 5 ]	= dec2bcd( now_tmp->tm_mon + 1 );
-	bf[ 6 ]	= dec2bcd( now_tmp->tm_year - 100 );
+	bf[ 0 ]	= 0;
+	bf[ 1 ]	= dec2bcd( now_tmp->tm_sec  );
+	bf[ 2 ]	= dec2bcd( now_tmp->tm_min  );
+	bf[ 3 ]	= dec2bcd( now_tmp->tm_hour );
+	bf[ 4 ]	= dec2bcd( now_tmp->tm_mday );
+	bf[ 6 ]	= dec2bcd( now_tmp->tm_mon + 1 );
+	bf[ 7 ]	= dec2bcd( now_tmp->tm_year - 100 );
 
 	now_time	= mktime( now_tmp );
 	cnv_tmp		= localtime( &now_time );
-	bf[ 4 ]		= dec2bcd( cnv_tmp->tm_wday);
+	bf[ 5 ]		= dec2bcd( cnv_tmp->tm_wday);
 	
+	set_time_regs( bf );
+}
+
+void PCF85063_base::rtc_time_regs( uint8_t* bf )
+{
+	bf[ 0 ]	= 0;
+	_reg_r( Seconds, bf + 1, 7 );
+}
+
+void PCF85063_base::set_time_regs( uint8_t* bf )
+{
 	_bit_op8( Control_1, ~0x20, 0x20 );
-	_reg_w( Seconds, bf, sizeof( bf ) );
+	_reg_w( Seconds, bf + 1, 7 );
 	_bit_op8( Control_1, ~0x20, 0x00 );
 }
 
+bool PCF85063_base::hold_time_regs( uint8_t* bf )
+{
+	ctrl1_hold	= _reg_r( Control_1 ) | 0x20;
+
+	_reg_w( Control_1, ctrl1_hold );
+	_reg_w( Seconds, bf + 1, 7 );
+	
+	return true;
+}
+
+void PCF85063_base::release_time_regs( void )
+{
+	_reg_w( Control_1, ctrl1_hold & ~0x20 );
+}
+
+//	snapshot blob: tag, size, Control_1..RAM_byte and Second_alarm..Timer_mode. Time registers are skipped
+
+#define	CONFIG_TAG	0x63
+#define	CONFIG_SIZE	(4 + Timer_mode - Second_alarm + 1)
+
+uint8_t PCF85063_base::save_config( uint8_t* blob )
+{
+	blob[ 0 ]	= CONFIG_TAG;
+	blob[ 1 ]	= CONFIG_SIZE;
+	
+	_reg_r( Control_1, blob + 2, 4 );
+	_reg_r( Second_alarm, blob + 6, CONFIG_SIZE - 4 );
+	
+	return CONFIG_SIZE + 2;
+}
+
+bool PCF85063_base::load_config( const uint8_t* blob )
+{
+	if ( (CONFIG_TAG != blob[ 0 ]) || (CONFIG_SIZE != blob[ 1 ]) )
+		return false;
+	
+	uint8_t	v[ 4 ];
+	
+	memcpy( v, blob + 2, sizeof( v ) );
+	v[ 0 ]	&= ~0x30;	//	Control_1: STOP and SR cleared
+	v[ 1 ]	|= 0x48;	//	Control_2: writing 1 keeps AF and TF
+
+	_reg_w( Control_1, v, sizeof( v ) );
+	_reg_w( Second_alarm, (uint8_t*)blob + 6, CONFIG_SIZE - 4 );
+	
+	return true;
+}
+
 bool PCF85063_base::oscillator_stop( void )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	return _reg_r( Seconds ) & 0x80;
 }
 
 void PCF85063_base::alarm( alarm_setting digit, int val )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	int	v = (val == 0x80) ? 0x80 : dec2bcd( val );
 	_reg_w( Second_alarm + digit, v );
 	_bit_op8( Control_2, (uint8_t)(~0x80), 0x80 );
 }
 
+void PCF85063_base::alarm_match( uint8_t mask, struct tm* alarm_tm )
+{
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	uint8_t	bf[ 5 ];
+	
+	alarm_regs( mask, alarm_tm, bf );
+	
+	_reg_w( Second_alarm, bf, sizeof( bf ) );
+	_bit_op8( Control_2, (uint8_t)(~0xC0), 0x80 );	//	AIE set and AF clear
+}
+
 void PCF85063_base::alarm_clear( void )
 {
 	//	will be implemented later
@@ -54,19 +136,47 @@ void PCF85063_base::alarm_clear( void )
 
 void PCF85063_base::alarm_disable( void )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	_bit_op8( Control_2, (uint8_t)(~0x80), 0x00 );	
 }
 
 uint8_t PCF85063_base::int_clear( void )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	uint8_t v = _reg_r( Control_2 );
+	RTC_NXP_TRACE_EVENT( "int_flags", v );
 	_reg_w( Control_2, v & ~0x48 );
 
 	return v;
 }
 
+void PCF85063_base::periodic_interrupt_enable( periodic_int_select sel )
+{
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	uint8_t	v	= (EVERY_MINUTE == sel) ? 0x20 : ((EVERY_HALF_MINUTE == sel) ? 0x10 : 0x00);	//	MI or HMI
+	
+	_bit_op8( Control_2, (uint8_t)(~0x78), v | 0x48 );	//	writing 1 keeps AF and TF
+}
+
+void PCF85063_base::set_clock_out( clock_out_frequency freq )
+{
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	_bit_op8( Control_2, ~0x07, freq );
+}
+
 float PCF85063_base::timer( float period, bool pulse )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	float	sf[] = { 1 / 4096.0, 1 / 64.0, 1.0, 60 };
 	int		tcf;
 	
@@ -106,6 +216,9 @@ float PCF85063_base::timer( float period, bool pulse )
 
 time_t PCF85063_base::rtc_time( void )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	struct tm	now_tm;
 
 	uint8_t		bf[ 7 ];
@@ -124,11 +237,11 @@ time_t PCF85063_base::rtc_time( void )
 }
 
 
-PCF85063A::PCF85063A( uint8_t i2c_address ) : I2C_device( i2c_address )
+PCF85063A::PCF85063A( uint8_t i2c_address ) : I2C_for_RTC( i2c_address )
 {
 }
 
-PCF85063A::PCF85063A( TwoWire& wire, uint8_t i2c_address ) : I2C_device( wire, i2c_address )
+PCF85063A::PCF85063A( TwoWire& wire, uint8_t i2c_address ) : I2C_for_RTC( wire, i2c_address )
 {
 }
 
@@ -17,3 +17,38 @@ PCF85063TP::PCF85063TP( TwoWire& wire, uint8_t i2c_address ) : PCF85063A( wire,
 PCF85063TP::~PCF85063TP()
 {	
 }
+
+void PCF85063TP::periodic_interrupt_enable( periodic_int_select )
+{
+	warning();
+}
+
+//	snapshot blob: tag, size, Control_1..RAM_byte. PCF85063TP has no alarm and timer registers
+
+#define	CONFIG_TAG	0x60
+#define	CONFIG_SIZE	(RAM_byte - Control_1 + 1)
+
+uint8_t PCF85063TP::save_config( uint8_t* blob )
+{
+	blob[ 0 ]	= CONFIG_TAG;
+	blob[ 1 ]	= CONFIG_SIZE;
+	
+	reg_r( Control_1, blob + 2, CONFIG_SIZE );
+	
+	return CONFIG_SIZE + 2;
+}
+
+bool PCF85063TP::load_config( const uint8_t* blob )
+{
+	if ( (CONFIG_TAG != blob[ 0 ]) || (CONFIG_SIZE != blob[ 1 ]) )
+		return false;
+	
+	uint8_t	v[ CONFIG_SIZE ];
+	
+	memcpy( v, blob + 2, sizeof( v ) );
+	v[ 0 ]	&= ~0x30;	//	Control_1: STOP and SR cleared. Control_2 has COF only (no flags)
+
+	reg_w( Control_1, v, sizeof( v ) );
+	
+	return true;
+}
@@ -1,10 +1,10 @@
 #include "RTC_NXP.h"
 
-PCF85263A::PCF85263A( uint8_t i2c_address ) : I2C_device( i2c_address )
+PCF85263A::PCF85263A( uint8_t i2c_address ) : I2C_for_RTC( i2c_address )
 {
 }
 
-PCF85263A::PCF85263A( TwoWire& wire, uint8_t i2c_address ) : I2C_device( wire, i2c_address )
+PCF85263A::PCF85263A( TwoWire& wire, uint8_t i2c_address ) : I2C_for_RTC( wire, i2c_address )
 {
 }
 
@@ -18,35 +18,117 @@ void PCF85263A::begin( void )
 
 void PCF85263A::set( struct tm* now_tmp )
 {
-	//	refer datasheet 7.2.6
-	
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	time_t		now_time;
 	struct tm*	cnv_tmp;
-	uint8_t		bf[ 10 ];
-	
-	bf[ 0 ]	= 0x01;
-	bf[ 1 ]	= 0xA4;
-	bf[ 2 ]	= 0;
-	bf[ 3 ]	= dec2bcd( now_tmp->tm_sec  );
-	bf[ 4 ]	= dec2bcd( now_tmp->tm_min  );
-	bf[ 5 ]	= dec2bcd( now_tmp->tm_hour );
-	bf[ 6 ]	= dec2bcd( now_tmp->tm_mday );
-	bf[ 8 ]	= dec2bcd( now_tmp->tm_mon + 1 );
-	bf[ 9 ]	= dec2bcd( now_tmp->tm_year - 100 );
+	uint8_t		bf[ 8 ];
+	
+	bf[ 0 ]	= 0;
+	bf[ 1 ]	= dec2bcd( now_tmp->tm_sec  );
+	bf[ 2 ]	= dec2bcd( now_tmp->tm_min  );
+	bf[ 3 ]	= dec2bcd( now_tmp->tm_hour );
+	bf[ 4 ]	= dec2bcd( now_tmp->tm_mday );
+	bf[ 6 ]	= dec2bcd( now_tmp->tm_mon + 1 );
+	bf[ 7 ]	= dec2bcd( now_tmp->tm_year - 100 );
 
 	now_time	= mktime( now_tmp );
 	cnv_tmp		= localtime( &now_time );
 	bf[ 5 ]		= dec2bcd( cnv_tmp->tm_wday );
 	
-	reg_w( Stop_enable, bf, sizeof( bf ) );
+	set_time_regs( bf );
+}
+
+void PCF85263A::rtc_time_regs( uint8_t* bf )
+{
+	reg_r( _100th_seconds, bf, 8 );
+}
+
+void PCF85263A::set_time_regs( uint8_t* bf )
+{
+	//	refer datasheet 7.2.6
+	
+	uint8_t		v[ 10 ];
+	
+	v[ 0 ]	= 0x01;	//	Stop_enable: STOP
+	v[ 1 ]	= 0xA4;	//	Resets: CPR (clear prescaler)
+	memcpy( v + 2, bf, 8 );
+	v[ 2 ]	= 0;	//	100th_seconds
+	
+	reg_w( Stop_enable, v, sizeof( v ) );
+	reg_w( Stop_enable, 0x00 );
+}
+
+bool PCF85263A::hold_time_regs( uint8_t* bf )
+{
+	uint8_t		v[ 10 ];
+	
+	v[ 0 ]	= 0x01;	//	Stop_enable: STOP
+	v[ 1 ]	= 0xA4;	//	Resets: CPR (clear prescaler)
+	memcpy( v + 2, bf, 8 );
+	v[ 2 ]	= 0;	//	100th_seconds
+	
+	reg_w( Stop_enable, v, sizeof( v ) );
+	
+	return true;
+}
+
+void PCF85263A::release_time_regs( void )
+{
 	reg_w( Stop_enable, 0x00 );
 }
 
+//	snapshot blob: tag, size, Second_alarm1..Alarm_enables and TSR_mode..Stop_enable
+//	Time, timestamp and Resets registers are skipped
+
+#define	CONFIG_TAG	0x26
+#define	CONFIG_SIZE	(Alarm_enables - Second_alarm1 + 1 + Stop_enable - TSR_mode + 1)
+
+uint8_t PCF85263A::save_config( uint8_t* blob )
+{
+	const int	n	= Alarm_enables - Second_alarm1 + 1;
+
+	blob[ 0 ]	= CONFIG_TAG;
+	blob[ 1 ]	= CONFIG_SIZE;
+	
+	reg_r( Second_alarm1, blob + 2, n );
+	reg_r( TSR_mode, blob + 2 + n, CONFIG_SIZE - n );
+	
+	return CONFIG_SIZE + 2;
+}
+
+bool PCF85263A::load_config( const uint8_t* blob )
+{
+	if ( (CONFIG_TAG != blob[ 0 ]) || (CONFIG_SIZE != blob[ 1 ]) )
+		return false;
+	
+	const int	n	= Alarm_enables - Second_alarm1 + 1;
+	uint8_t		v[ Stop_enable - TSR_mode + 1 ];
+	
+	memcpy( v, blob + 2 + n, sizeof( v ) );
+	v[ Flags       - TSR_mode ]	= 0xFF;	//	writing 1 keeps flags
+	v[ Stop_enable - TSR_mode ]	= 0x00;
+
+	reg_w( Second_alarm1, (uint8_t*)blob + 2, n );
+	reg_w( TSR_mode, v, sizeof( v ) );
+	
+	return true;
+}
+
 bool PCF85263A::oscillator_stop( void )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	return reg_r( Seconds ) & 0x80;
 }
 
+bool PCF85263A::has_hundredths( void )
+{
+	return true;
+}
+
 void PCF85263A::alarm( alarm_setting digit, int val )
 {
 	alarm( digit, val, 0 );
@@ -54,6 +136,9 @@ void PCF85263A::alarm( alarm_setting digit, int val )
 
 void PCF85263A::alarm( alarm_setting digit, int val, int int_sel )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	if ( WEEKDAY == digit ) {
 		Serial.println("*** 'WEEKDAY' for PCF85263A is unsupported alarm setting ***");		
 		return;
@@ -69,6 +154,9 @@ void PCF85263A::alarm( alarm_setting_85263A digit, int val, int int_sel )
 
 void PCF85263A::set_alarm( int digit, int val, int int_sel )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	uint8_t	en;
 
 	en	= ((val & 80) ? 0x0 : 0x1) << digit;
@@ -80,27 +168,79 @@ void PCF85263A::set_alarm( int digit, int val, int int_sel )
 	bit_op8( INTA_enable + int_sel, ~en_bit, en_bit );	
 }
 
+void PCF85263A::alarm_match( uint8_t mask, struct tm* alarm_tm )
+{
+	alarm_match( mask, alarm_tm, 0 );
+}
+
+void PCF85263A::alarm_match( uint8_t mask, struct tm* alarm_tm, int int_sel )
+{
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	if ( mask & MATCH_WEEKDAY ) {
+		Serial.println("*** 'MATCH_WEEKDAY' for PCF85263A is unsupported alarm setting ***");		
+		return;
+	}
+
+	uint8_t	bf[ 9 ];	//	Second_alarm1 .. Alarm_enables
+	
+	//	alarm2 and its enable bits are kept as those are in same burst
+	reg_r( Minute_alarm2, bf + 5, 4 );
+
+	bf[ 0 ]	= dec2bcd( alarm_tm->tm_sec  );
+	bf[ 1 ]	= dec2bcd( alarm_tm->tm_min  );
+	bf[ 2 ]	= dec2bcd( alarm_tm->tm_hour );
+	bf[ 3 ]	= dec2bcd( alarm_tm->tm_mday );
+	bf[ 4 ]	= dec2bcd( alarm_tm->tm_mon + 1 );
+	bf[ 8 ]	= (bf[ 8 ] & ~0x1F) | (mask & (MATCH_SECOND | MATCH_MINUTE | MATCH_HOUR | MATCH_DAY));
+	
+	reg_w( Second_alarm1, bf, sizeof( bf ) );
+	bit_op8( INTA_enable + int_sel, ~0x10, 0x10 );	
+}
+
 void PCF85263A::alarm_clear( void )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	reg_w( Alarm_enables, 0x00 );
 }
 
 void PCF85263A::alarm_disable( void )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	bit_op8( INTA_enable, ~0x18, 0x18 );	
 	bit_op8( INTB_enable, ~0x18, 0x18 );	
 }
 
 uint8_t PCF85263A::int_clear( void )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	uint8_t	status	= reg_r( Flags );
+	RTC_NXP_TRACE_EVENT( "int_flags", status );
 	
 	reg_w( Flags, ~status );
 	return status;
 }
 
+void PCF85263A::set_clock_out( clock_out_frequency freq )
+{
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	bit_op8( Function, ~0x07, freq );
+}
+
 time_t PCF85263A::rtc_time( void )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	struct tm	now_tm;
 	uint8_t		bf[ 8 ];
 	
@@ -119,6 +259,9 @@ time_t PCF85263A::rtc_time( void )
 
 void PCF85263A::periodic_interrupt_enable( periodic_int_select sel, int int_sel )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	bit_op8( Function, ~0x60, sel << 5 );
 	bit_op8( Function, ~0x60, sel << 5 );
 	
@@ -127,17 +270,26 @@ void PCF85263A::periodic_interrupt_enable( periodic_int_select sel, int int_sel
 
 void PCF85263A::pin_config( inta cfg_a, intb cfg_b ) 
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	bit_op8(Pin_IO, ~0x0F, (cfg_b << 2) | cfg_a);
 }
 
 void PCF85263A::ts_config( int setting )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	bit_op8( Pin_IO, 0x0F, setting );
 	bit_op8( INTA_enable, ~0x04, 0x04 );	
 }
 
 time_t PCF85263A::timestamp( int num )
 {
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
 	struct tm	ts_tm;
 	uint8_t		bf[ 6 ];
 	const int	offset	= 6;
@@ -1,13 +1,31 @@
 #include "RTC_NXP.h"
 
+#if RTC_NXP_MULTITHREAD
+RTC_NXP::RTC_NXP() : bus_lock_p( NULL )
+{
+}
+#else
 RTC_NXP::RTC_NXP()
 {
 }
+#endif
 
 RTC_NXP::~RTC_NXP()
 {
 }
 
+#if RTC_NXP_MULTITHREAD
+void RTC_NXP::bus_lock( RTC_lock* lock )
+{
+	bus_lock_p	= lock;
+}
+
+RTC_lock* RTC_NXP::bus_lock( void )
+{
+	return bus_lock_p;
+}
+#endif
+
 time_t RTC_NXP::time( time_t* tp )
 {
 	time_t	t	= rtc_time();
@@ -16,6 +34,216 @@ time_t RTC_NXP::time( time_t* tp )
 	return t;
 }
 
+time_t RTC_NXP::time_2000( void )
+{
+	struct tm	y2k_tm;
+
+	memset( &y2k_tm, 0, sizeof( y2k_tm ) );
+	y2k_tm.tm_year	= 100;
+	y2k_tm.tm_mday	= 1;
+
+	return mktime( &y2k_tm );
+}
+
+void RTC_NXP::alarm_at( time_t t )
+{
+	alarm_match( MATCH_SECOND | MATCH_MINUTE | MATCH_HOUR | MATCH_DAY, localtime( &t ) );
+}
+
+uint32_t RTC_NXP::now32( void )
+{
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	uint8_t	bf[ 8 ];
+	
+	rtc_time_regs( bf );
+	return bcd2epoch( bf );
+}
+
+uint32_t RTC_NXP::now32( uint8_t* hundredths )
+{
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	uint8_t	bf[ 8 ];
+	
+	rtc_time_regs( bf );
+	*hundredths	= bcd2dec( bf[ 0 ] );
+
+	return bcd2epoch( bf );
+}
+
+bool RTC_NXP::has_hundredths( void )
+{
+	return false;
+}
+
+void RTC_NXP::set32( uint32_t t )
+{
+	RTC_NXP_TRACE_SCOPE();
+
+	uint8_t	bf[ 8 ];
+	
+	epoch2bcd( t, bf );
+
+	{
+		RTC_NXP_GUARD();
+		set_time_regs( bf );
+	}
+
+	settle();	//	other devices on the bus can be accessed while waiting
+}
+
+bool RTC_NXP::preload( uint32_t t )
+{
+	RTC_NXP_TRACE_SCOPE();
+
+	uint8_t	bf[ 8 ];
+	
+	epoch2bcd( t, bf );
+	settle();
+
+	RTC_NXP_GUARD();
+	return hold_time_regs( bf );
+}
+
+void RTC_NXP::release( void )
+{
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	release_time_regs();
+}
+
+uint8_t RTC_NXP::snapshot( uint8_t* blob )
+{
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	return save_config( blob );
+}
+
+bool RTC_NXP::restore( const uint8_t* blob )
+{
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	return load_config( blob );
+}
+
+bool RTC_NXP::hold_time_regs( uint8_t* bf )
+{
+	(void)bf;
+	return false;
+}
+
+void RTC_NXP::release_time_regs( void )
+{
+}
+
+void RTC_NXP::settle( void )
+{
+}
+
+uint8_t RTC_NXP::save_config( uint8_t* blob )
+{
+	(void)blob;
+	return 0;
+}
+
+bool RTC_NXP::load_config( const uint8_t* blob )
+{
+	(void)blob;
+	return false;
+}
+
+//	Date calculation is done in March based year, counted from 1996-03-01.
+//	The leap day comes at end of every 4 years cycle in this counting and 
+//	it is valid from year 2000 to 2099 (range of the RTC registers)
+
+#define	DAYS_1996MAR_TO_2000JAN	1401
+#define	DAY_SECONDS				86400UL
+
+uint32_t RTC_NXP::bcd2epoch( const uint8_t* bf )
+{
+	uint8_t		mon	= bcd2dec( bf[ 6 ] & 0x1F );
+	uint8_t		y	= bcd2dec( bf[ 7 ] ) + 4 - ((mon <= 2) ? 1 : 0);
+	uint8_t		m	= (mon <= 2) ? mon + 9 : mon - 3;
+	uint16_t	days;
+	
+	days	 = 365U * y + y / 4 + (153 * m + 2) / 5 + bcd2dec( bf[ 4 ] & 0x3F ) - 1;
+	days	-= DAYS_1996MAR_TO_2000JAN;
+	
+	return days * DAY_SECONDS 
+			+ bcd2dec( bf[ 3 ] & 0x3F ) * 3600UL
+			+ bcd2dec( bf[ 2 ] & 0x7F ) * 60
+			+ bcd2dec( bf[ 1 ] & 0x7F );
+}
+
+void RTC_NXP::epoch2bcd( uint32_t t, uint8_t* bf )
+{
+	uint16_t	days	= t / DAY_SECONDS;
+	uint32_t	sec		= t % DAY_SECONDS;
+	uint16_t	d		= days + DAYS_1996MAR_TO_2000JAN;
+	uint8_t		y		= (4UL * d + 3) / 1461;
+	uint16_t	doy		= d - (365U * y + y / 4);
+	uint8_t		m		= (5 * doy + 2) / 153;
+	uint8_t		mon		= (m < 10) ? m + 3 : m - 9;
+	
+	bf[ 0 ]	= 0;
+	bf[ 1 ]	= dec2bcd( sec % 60 );
+	bf[ 2 ]	= dec2bcd( (sec / 60) % 60 );
+	bf[ 3 ]	= dec2bcd( sec / 3600 );
+	bf[ 4 ]	= dec2bcd( doy - (153 * m + 2) / 5 + 1 );
+	bf[ 5 ]	= (days + 6) % 7;	//	2000-01-01 was Saturday
+	bf[ 6 ]	= dec2bcd( mon );
+	bf[ 7 ]	= dec2bcd( y - 4 + ((mon <= 2) ? 1 : 0) );
+}
+
+char* RTC_NXP::iso8601( char* s, bool hundredths )
+{
+	RTC_NXP_TRACE_SCOPE();
+	RTC_NXP_GUARD();
+
+	uint8_t	bf[ 8 ];
+	
+	rtc_time_regs( bf );
+	return iso8601( s, bf, hundredths );
+}
+
+static char* bcd2chars( char* p, uint8_t v, char delimiter )
+{
+	*p++	= '0' + (v >> 4);
+	*p++	= '0' + (v & 0x0F);
+	
+	if ( delimiter )
+		*p++	= delimiter;
+	
+	return p;
+}
+
+char* RTC_NXP::iso8601( char* s, const uint8_t* bf, bool hundredths )
+{
+	char*	p	= s;
+	
+	*p++	= '2';
+	*p++	= '0';
+	p		= bcd2chars( p, bf[ 7 ],        '-' );
+	p		= bcd2chars( p, bf[ 6 ] & 0x1F, '-' );
+	p		= bcd2chars( p, bf[ 4 ] & 0x3F, 'T' );
+	p		= bcd2chars( p, bf[ 3 ] & 0x3F, ':' );
+	p		= bcd2chars( p, bf[ 2 ] & 0x7F, ':' );
+	p		= bcd2chars( p, bf[ 1 ] & 0x7F, hundredths ? '.' : 0 );
+	
+	if ( hundredths )
+		p	= bcd2chars( p, bf[ 0 ], 0 );
+
+	*p		= '\0';
+	
+	return s;
+}
+
 uint8_t	RTC_NXP::bcd2dec( uint8_t v )
 {
 	return (v >> 4) * 10 + (v & 0x0F);
@@ -26,6 +254,19 @@ uint8_t	RTC_NXP::dec2bcd( uint8_t v )
 	return ((v / 10) << 4) + (v % 10);
 }
 
+void RTC_NXP::alarm_regs( uint8_t mask, struct tm* alarm_tm, uint8_t* bf )
+{
+	bf[ SECOND  ]	= dec2bcd( alarm_tm->tm_sec  );
+	bf[ MINUTE  ]	= dec2bcd( alarm_tm->tm_min  );
+	bf[ HOUR    ]	= dec2bcd( alarm_tm->tm_hour );
+	bf[ DAY     ]	= dec2bcd( alarm_tm->tm_mday );
+	bf[ WEEKDAY ]	= dec2bcd( alarm_tm->tm_wday );
+	
+	for ( int i = SECOND; i <= WEEKDAY; i++ )
+		if ( !(mask & (0x01 << i)) )
+			bf[ i ]	= 0x80;
+}
+
 /*
 ForFutureExtention::ForFutureExtention(){}
 ForFutureExtention::~ForFutureExtention(){}
@@ -33,9 +274,13 @@ void ForFutureExtention::begin( void ){}
 void ForFutureExtention::set( struct tm* now_tm ){}
 bool ForFutureExtention::oscillator_stop( void ){}
 void ForFutureExtention::alarm( alarm_setting digit, int val ){}
+void ForFutureExtention::alarm_match( uint8_t mask, struct tm* alarm_tm ){}
 void ForFutureExtention::alarm_clear( void ){}
 void ForFutureExtention::alarm_disable( void ){}
 uint8_t ForFutureExtention::int_clear( void ){}
+void ForFutureExtention::set_clock_out( clock_out_frequency freq ){}
 time_t ForFutureExtention::rtc_time( void ){}
+void ForFutureExtention::rtc_time_regs( uint8_t* bf ){}
+void ForFutureExtention::set_time_regs( uint8_t* bf ){}
 */
 
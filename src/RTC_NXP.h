@@ -15,6 +15,328 @@
 #include <I2C_device.h>
 #include <SPI.h>
 
+/** Multithread support
+ *
+ *	If RTC_NXP_MULTITHREAD is 1, driver methods are executed atomically with a lock set by bus_lock(). 
+ *	It is enabled by default on ESP32 and Linux host. To change it, define it in compiler flags for whole build. 
+ *	If it is 0, code for locking is not compiled at all. 
+ */
+#ifndef RTC_NXP_MULTITHREAD
+#if defined( ESP32 ) || defined( RTC_NXP_HOST )
+#define RTC_NXP_MULTITHREAD	1
+#else
+#define RTC_NXP_MULTITHREAD	0
+#endif
+#endif
+
+#if RTC_NXP_MULTITHREAD
+#include <mutex>
+#define	RTC_NXP_GUARD()		RTC_lock_guard	rtc_nxp_guard( bus_lock_p )
+#else
+#define	RTC_NXP_GUARD()
+#endif
+
+/** std::chrono support
+ *
+ *	If RTC_NXP_CHRONO is 1, rtc_nxp_clock (std::chrono clock) is available. 
+ *	It is enabled by default on C++11 or later if <chrono> exists (not on AVR). 
+ */
+#ifndef RTC_NXP_CHRONO
+#if defined( __has_include ) && (__cplusplus >= 201103L)
+#if __has_include( <chrono> )
+#define RTC_NXP_CHRONO	1
+#endif
+#endif
+#endif
+
+#ifndef RTC_NXP_CHRONO
+#define RTC_NXP_CHRONO	0
+#endif
+
+#if RTC_NXP_CHRONO
+#include <chrono>
+#endif
+
+/** Tracing hooks
+ *
+ *	If RTC_NXP_TRACE is 1, driver methods report enter/exit and events to a sink set by RTC_trace::sink(). 
+ *	It is enabled by default on Linux host only. To change it, define it in compiler flags for whole build. 
+ *	If it is 0, the hooks are compiled to nothing (arguments of RTC_NXP_TRACE_EVENT() are not evaluated). 
+ */
+#ifndef RTC_NXP_TRACE
+#if defined( RTC_NXP_HOST )
+#define RTC_NXP_TRACE	1
+#else
+#define RTC_NXP_TRACE	0
+#endif
+#endif
+
+#if RTC_NXP_TRACE
+#define	RTC_NXP_TRACE_SCOPE()				RTC_trace_scope	rtc_nxp_trace_scope( __func__, this )
+#define	RTC_NXP_TRACE_EVENT( name, value )	RTC_trace::emit( name, this, value )
+#else
+#define	RTC_NXP_TRACE_SCOPE()
+#define	RTC_NXP_TRACE_EVENT( name, value )	((void)0)
+#endif
+
+/** I2C buffer size
+ *
+ *	RTC_NXP_I2C_BUFFER is the buffer size of TwoWire: maximum data size of a read, 
+ *	and of a write including the register address. Longer accesses fail with BUS_DATA_TOO_LONG 
+ *	without any bus transfer, so driver methods split longer register bursts. 
+ *	It is taken from Wire.h of the core (32 on AVR). 
+ */
+#ifndef RTC_NXP_I2C_BUFFER
+#if defined( WIRE_BUFFER_LENGTH )
+#define RTC_NXP_I2C_BUFFER	WIRE_BUFFER_LENGTH
+#elif defined( I2C_BUFFER_LENGTH )
+#define RTC_NXP_I2C_BUFFER	I2C_BUFFER_LENGTH
+#elif defined( BUFFER_LENGTH )
+#define RTC_NXP_I2C_BUFFER	BUFFER_LENGTH
+#else
+#define RTC_NXP_I2C_BUFFER	32
+#endif
+#endif
+
+/** Bus error statistics
+ *
+ *	If RTC_NXP_BUS_STATS is 1, I2C_for_RTC counts failed accesses, retries and fallbacks. 
+ *	It is enabled by default except on AVR. To change it, define it in compiler flags for whole build. 
+ *	If it is 0, the counters are not allocated (10 bytes less in each I2C driver instance on AVR) 
+ *	and errors(), retries() and fallbacks() return 0. 
+ */
+#ifndef RTC_NXP_BUS_STATS
+#if defined( __AVR__ )
+#define RTC_NXP_BUS_STATS	0
+#else
+#define RTC_NXP_BUS_STATS	1
+#endif
+#endif
+
+#if RTC_NXP_MULTITHREAD
+/** RTC_lock class
+ *	
+ *	A base class of locking policy for shared bus. 
+ *	lock()/unlock() in derived class must be recursive since driver methods call other driver methods. 
+ *	Time holding the lock is measured for outermost lock. 
+ *
+ *  @class RTC_lock
+ */
+
+class RTC_lock
+{
+public:
+	/** Constructor */
+	RTC_lock();
+
+	/** Destructor */
+	virtual ~RTC_lock();
+
+	/** Acquire the lock */
+	void acquire( void );
+
+	/** Release the lock */
+	void release( void );
+
+	/** Number of acquisitions (outermost) */
+	unsigned long count( void );
+
+	/** Maximum time of holding the lock in microseconds */
+	unsigned long hold_max( void );
+
+	/** Mean time of holding the lock in microseconds */
+	float hold_mean( void );
+
+	/** Maximum time of waiting for the lock in microseconds */
+	unsigned long wait_max( void );
+
+	/** Statistics clearing */
+	void reset_statistics( void );
+
+protected:
+	/** Lock (pure virtual method) */
+	virtual void lock( void )	= 0;
+
+	/** Unlock (pure virtual method) */
+	virtual void unlock( void )	= 0;
+
+private:
+	int				depth;
+	unsigned long	start_us;
+	unsigned long	n_count;
+	unsigned long	h_max;
+	float			h_sum;
+	unsigned long	w_max;
+};
+
+/** RTC_std_lock class
+ *	
+ *	Locking policy using std::recursive_mutex
+ *
+ *  @class RTC_std_lock
+ */
+
+class RTC_std_lock : public RTC_lock
+{
+protected:
+	void lock( void );
+	void unlock( void );
+
+private:
+	std::recursive_mutex	mtx;
+};
+
+/** RTC_lock_guard class
+ *	
+ *	Holding a lock in a scope. Nothing is done if the lock is nullptr
+ *
+ *  @class RTC_lock_guard
+ */
+
+class RTC_lock_guard
+{
+public:
+	RTC_lock_guard( RTC_lock* lock ) : lk( lock )	{ if ( lk ) lk->acquire(); }
+	~RTC_lock_guard()								{ if ( lk ) lk->release(); }
+
+private:
+	RTC_lock	*lk;
+};
+#endif	//	RTC_NXP_MULTITHREAD
+
+#if RTC_NXP_TRACE
+/** RTC_trace class
+ *	
+ *	A base class of trace sinks. 
+ *	Driver methods call enter() and exit() with the method name and the instance address. 
+ *	Events in the methods (interrupt flags, retries, etc.) are given to event() with a value. 
+ *	Bus events ("bus_retry", "bus_fallback") have address of I2C_for_RTC part of the instance. 
+ *	Sink methods are called in the context of driver methods: keep those short. 
+ *
+ *  @class RTC_trace
+ */
+
+class RTC_trace
+{
+public:
+	virtual ~RTC_trace() {}
+
+	/** Method entry
+	 *
+	 * @param name method name
+	 * @param dev instance address
+	 */
+	virtual void enter( const char* name, const void* dev )	= 0;
+
+	/** Method exit
+	 *
+	 * @param name method name
+	 * @param dev instance address
+	 */
+	virtual void exit( const char* name, const void* dev )	= 0;
+
+	/** Event in a method
+	 *
+	 * @param name event name
+	 * @param dev instance address
+	 * @param value event value
+	 */
+	virtual void event( const char* name, const void* dev, uint32_t value )	= 0;
+
+	/** Set sink
+	 *
+	 * @param s sink instance. nullptr to stop tracing
+	 */
+	static void sink( RTC_trace* s );
+
+	/** Current sink */
+	static inline RTC_trace* sink( void )	{ return active; }
+
+	/** Give an event to current sink */
+	static inline void emit( const char* name, const void* dev, uint32_t value )	{ if ( active ) active->event( name, dev, value ); }
+
+private:
+	static RTC_trace*	active;
+};
+
+/** RTC_trace_scope class
+ *	
+ *	Reports enter/exit of a scope to the sink
+ *
+ *  @class RTC_trace_scope
+ */
+
+class RTC_trace_scope
+{
+public:
+	RTC_trace_scope( const char* name, const void* dev ) : sink_p( RTC_trace::sink() ), name( name ), dev( dev )	{ if ( sink_p ) sink_p->enter( name, dev ); }
+	~RTC_trace_scope()	{ if ( sink_p ) sink_p->exit( name, dev ); }
+
+private:
+	RTC_trace*	sink_p;
+	const char*	name;
+	const void*	dev;
+};
+
+/** RTC_trace_buffer class
+ *	
+ *	Trace sink storing records into a ring buffer. Oldest records are overwritten when it is full. 
+ *	Records are printed by dump() with micros() time stamps. 
+ *
+ *  @class RTC_trace_buffer
+ */
+
+class RTC_trace_buffer : public RTC_trace
+{
+public:
+	/** Trace record */
+	struct record {
+		unsigned long	us;		//	micros()
+		const char*		name;
+		const void*		dev;
+		uint32_t		value;
+		char			type;	//	'B': enter, 'E': exit, 'i': event
+	};
+
+	/** Create a RTC_trace_buffer instance
+	 *
+	 * @param buffer record buffer
+	 * @param size number of records in the buffer
+	 */
+	RTC_trace_buffer( record* buffer, uint16_t size );
+
+	/** Destructor */
+	virtual ~RTC_trace_buffer();
+
+	void enter( const char* name, const void* dev );
+	void exit( const char* name, const void* dev );
+	void event( const char* name, const void* dev, uint32_t value );
+
+	/** Print records and clear the buffer
+	 *
+	 *	Each line is "micros type name dev value"
+	 *
+	 * @param out output (e.g. Serial)
+	 */
+	void dump( Print& out );
+
+	/** Number of records in the buffer */
+	uint16_t available( void );
+
+	/** Number of overwritten records */
+	uint32_t overwritten( void );
+
+private:
+	void	put( char type, const char* name, const void* dev, uint32_t value );
+
+	record		*buf;
+	uint16_t	buf_size;
+	uint16_t	head;
+	uint16_t	count;
+	uint32_t	n_overwritten;
+};
+#endif	//	RTC_NXP_TRACE
+
 /** RTC_NXP class
  *	
  *  @class RTC_NXP
@@ -39,6 +361,35 @@ public:
 		DAY,
 		WEEKDAY,
 	};
+	/** Clock output frequency descriptor */
+	enum clock_out_frequency {
+		FREQ_32768_HZ,
+		FREQ_16384_HZ,
+		FREQ_8192_HZ,
+		FREQ_4096_HZ,
+		FREQ_2048_HZ,
+		FREQ_1024_HZ,
+		FREQ_1_HZ,
+		FREQ_DISABLE
+	};
+	/** Alarm matching flags for alarm_match() */
+	enum alarm_match_flag {
+		MATCH_SECOND	= 0x01 << SECOND,
+		MATCH_MINUTE	= 0x01 << MINUTE,
+		MATCH_HOUR		= 0x01 << HOUR,
+		MATCH_DAY		= 0x01 << DAY,
+		MATCH_WEEKDAY	= 0x01 << WEEKDAY,
+	};
+	/** Buffer size for snapshot() */
+	enum {
+		SNAPSHOT_SIZE	= 48,
+	};
+	/** Bus speed profile descriptor for bus_profile() */
+	enum bus_speed {
+		BUS_SPEED_STANDARD,	//	I2C 100 kHz, SPI 1 MHz
+		BUS_SPEED_FAST,		//	I2C 400 kHz, SPI 4 MHz
+		BUS_SPEED_MAXIMUM,	//	maximum clock of the device
+	};
 
 	/** Constructor */
 	RTC_NXP();
@@ -57,6 +408,97 @@ public:
 	 * @return time_t value of current time
 	 */
 	time_t time( time_t* tp );
+
+	/** time_t of 2000-01-01 00:00:00
+	 *
+	 *	Calendar in RTC is taken as local time by mktime(), same as time(). 
+	 *	Use this to convert between time_t and seconds since 2000-01-01 00:00:00 (now32()/set32())
+	 *
+	 * @return time_t value of 2000-01-01 00:00:00
+	 */
+	static time_t time_2000( void );
+
+	/** now32
+	 *
+	 *	Current time in seconds since 2000-01-01 00:00:00.
+	 *	Converted straight from BCD registers without using "struct tm"
+	 *
+	 * @return uint32_t seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( void );
+
+	/** now32 with 100th-seconds
+	 *
+	 * @param hundredths pointer to store 100th-seconds (0 on devices which don't have 100th-seconds register)
+	 * @return uint32_t seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( uint8_t* hundredths );
+
+	/** 100th-seconds register availability
+	 *
+	 * @return true if the device has 100th-seconds register
+	 */
+	virtual bool has_hundredths( void );
+
+	/** set32
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00 to set calendar and time in RTC
+	 */
+	void set32( uint32_t t );
+
+	/** Load time with the clock stopped
+	 *
+	 *	Time registers are written with STOP bit set and the prescaler cleared. 
+	 *	The clock starts from this time by release(). Used to start RTCs at same instant (see RTC_group)
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00
+	 * @return false if the device has no STOP bit (nothing done)
+	 */
+	bool preload( uint32_t t );
+
+	/** Start the clock stopped by preload(). Done by one register write
+	 */
+	void release( void );
+
+	/** Configuration snapshot
+	 *
+	 *	Configuration registers are read in a few bursts (each fits in the I2C buffer) into a blob of chip tag, data size and register data. 
+	 *	Time registers are not included
+	 *
+	 * @param blob pointer to buffer of SNAPSHOT_SIZE bytes
+	 * @return blob size. 0 if the device is not supported
+	 */
+	uint8_t snapshot( uint8_t* blob );
+
+	/** Restore configuration from snapshot
+	 *
+	 *	Registers are written in a few bursts (each fits in the I2C buffer). 
+	 *	Time registers, STOP bit and reset commands are not written. Interrupt flags are kept as those are
+	 *
+	 * @param blob pointer to blob made by snapshot() on same type of device
+	 * @return false if the blob is not for this type of device
+	 */
+	bool restore( const uint8_t* blob );
+
+	/** ISO 8601 time string
+	 *
+	 *	Writes "YYYY-MM-DDThh:mm:ss" or "YYYY-MM-DDThh:mm:ss.cc" into given buffer.
+	 *	BCD registers are converted into characters directly without binary conversion
+	 *
+	 * @param s pointer to char buffer. 20 bytes needed, 23 bytes with hundredths
+	 * @param hundredths appending ".cc" if true. It will be ".00" on devices which don't have 100th-seconds register
+	 * @return pointer to the string
+	 */
+	char* iso8601( char* s, bool hundredths = false );
+
+	/** Class method for ISO 8601 time string from time register image
+	 *
+	 * @param s pointer to char buffer. 20 bytes needed, 23 bytes with hundredths
+	 * @param bf pointer to 8 bytes time register image
+	 * @param hundredths appending ".cc" if true
+	 * @return pointer to the string
+	 */
+	static char* iso8601( char* s, const uint8_t* bf, bool hundredths = false );
 	
 	/** set (pure virtual method)
 	 * 
@@ -77,6 +519,21 @@ public:
 	 */
 	virtual void alarm( alarm_setting digit, int val )	= 0;
 
+	/** Alarm setting for all digits at once (pure virtual method)
+	 * 
+	 * @param mask digits to be matched. Compose value by ORing MATCH_SECOND, MATCH_MINUTE, MATCH_HOUR, MATCH_DAY and MATCH_WEEKDAY
+	 * @param alarm_tm struct to specify alarm time
+	 */
+	virtual void alarm_match( uint8_t mask, struct tm* alarm_tm )	= 0;
+
+	/** Alarm setting by time_t
+	 * 
+	 *	Sets alarm matching to second, minute, hour and day of given time
+	 *
+	 * @param t alarm time
+	 */
+	void alarm_at( time_t t );
+
 	/** Alarm clearing (pure virtual method)
 	 */
 	virtual void alarm_clear( void )	= 0;
@@ -89,13 +546,102 @@ public:
 	 */
 	virtual uint8_t int_clear( void )	= 0;
 
+	/** Set clock output (CLKOUT) (pure virtual method)
+	 *
+	 * @param freq choose desired clock output (CLKOUT) frequency in 'enum clock_out_frequency'
+	 */
+	virtual void set_clock_out( clock_out_frequency freq )	= 0;
+
+#if RTC_NXP_MULTITHREAD
+	/** Set lock for shared bus
+	 *
+	 *	Driver methods are executed holding the lock. 
+	 *	Devices on same bus should share one lock. 
+	 *
+	 * @param lock lock instance. nullptr for no locking
+	 */
+	void bus_lock( RTC_lock* lock );
+
+	/** Get lock for shared bus
+	 *
+	 *	Use this with RTC_lock_guard to access registers directly from multiple threads
+	 *
+	 * @return lock instance
+	 */
+	RTC_lock* bus_lock( void );
+#endif
+
 protected:
+#if RTC_NXP_MULTITHREAD
+	RTC_lock	*bus_lock_p;
+#endif
+
 	/** rtc_time (pure virtual method)
 	 * 
 	 * @return time_t returns RTC time in time_t format
 	 */
 	virtual time_t rtc_time( void )	= 0;
-		
+
+	/** Read time registers (pure virtual method)
+	 *
+	 *	Time register image is 8 bytes of BCD in order of
+	 *	100th-seconds, seconds, minutes, hours, days, weekdays, months and years.
+	 *	100th-seconds is 0 on devices which don't have the register
+	 *
+	 * @param bf pointer to 8 bytes buffer for time register image
+	 */
+	virtual void rtc_time_regs( uint8_t* bf )	= 0;
+
+	/** Write time registers (pure virtual method)
+	 *
+	 * @param bf pointer to 8 bytes time register image. Same format as rtc_time_regs()
+	 */
+	virtual void set_time_regs( uint8_t* bf )	= 0;
+
+	/** Write time registers with STOP bit set. Default: no STOP bit
+	 *
+	 * @param bf pointer to 8 bytes time register image
+	 * @return false if the device has no STOP bit
+	 */
+	virtual bool hold_time_regs( uint8_t* bf );
+
+	/** Clear STOP bit set by hold_time_regs() */
+	virtual void release_time_regs( void );
+
+	/** Wait for the device after time setting. Called without holding the bus lock. Default: nothing
+	 *
+	 *	Called after set_time_regs() and before hold_time_regs(). 
+	 */
+	virtual void settle( void );
+
+	/** Read configuration registers into snapshot blob. Default: not supported
+	 *
+	 * @param blob pointer to buffer of SNAPSHOT_SIZE bytes
+	 * @return blob size. 0 if not supported
+	 */
+	virtual uint8_t save_config( uint8_t* blob );
+
+	/** Write configuration registers from snapshot blob. Default: not supported
+	 *
+	 * @param blob pointer to blob
+	 * @return false if the blob is not for this type of device
+	 */
+	virtual bool load_config( const uint8_t* blob );
+
+	/** Class method for time register image to seconds since 2000 conversion
+	 *
+	 * @param bf pointer to 8 bytes time register image
+	 * @return seconds since 2000-01-01 00:00:00
+	 */
+	static uint32_t	bcd2epoch( const uint8_t* bf );
+
+	/** Class method for seconds since 2000 to time register image conversion
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00
+	 * @param bf pointer to 8 bytes buffer for time register image
+	 */
+	static void		epoch2bcd( uint32_t t, uint8_t* bf );
+
 	/** Class method for BCD to int conversion
 	 * 
 	 * @param v BCD value
@@ -109,6 +655,17 @@ protected:
 	 * @return BCD value
 	 */
 	static uint8_t	dec2bcd( uint8_t v );
+
+	/** Class method for alarm register values
+	 *
+	 *	Fills 5 bytes of second, minute, hour, day and weekday alarm values in BCD. 
+	 *	Digits not in the mask are set 0x80 (disabled)
+	 * 
+	 * @param mask digits to be matched
+	 * @param alarm_tm struct to specify alarm time
+	 * @param bf pointer to 5 bytes buffer for alarm registers
+	 */
+	static void		alarm_regs( uint8_t mask, struct tm* alarm_tm, uint8_t* bf );
 };
 
 
@@ -149,18 +706,31 @@ public:
 		LAST,
 		FIRST,
 	};
-    /** Clock output frequency descriptor */
-    enum clock_out_frequency
-    {
-        FREQ_32768_HZ,
-        FREQ_16384_HZ,
-        FREQ_8192_HZ,
-        FREQ_4096_HZ,
-        FREQ_2048_HZ,
-        FREQ_1024_HZ,
-        FREQ_1_HZ,
-        FREQ_DISABLE
-    };
+	/** Interrupt output descriptor for config. ROUTE_INT_A and ROUTE_INT_B are same as int_sel 0 and 1 */
+	enum int_route {
+		ROUTE_INT_A,
+		ROUTE_INT_B,
+		ROUTE_NONE,
+	};
+	/** Configuration descriptor for apply()
+	 *
+	 *	Constructor gives the register reset state: all interrupts disabled, 32768 Hz clock out, 
+	 *	timestamps in LAST mode, watchdog disabled and no offset. 
+	 */
+	struct config {
+		periodic_int_select	periodic;		//	DISABLE, EVERY_SECOND or EVERY_MINUTE
+		int_route			periodic_int;	//	output of the periodic interrupt
+		int_route			alarm_int;		//	output of the alarm interrupt. ROUTE_NONE disables it (AIE)
+		int_route			watchdog_int;	//	output of the watchdog interrupt
+		int_route			ts_int[ 4 ];	//	output of timestamp 1~4 interrupts. ROUTE_NONE disables it (TSIE)
+		timestamp_setting	ts_mode[ 4 ];	//	LAST or FIRST for timestamp 1~4
+		clock_out_frequency	clock_out;		//	CLKOUT frequency
+		uint8_t				watchdog_ctl;	//	Watchdg_tim_ctl register value
+		uint8_t				watchdog_val;	//	Watchdg_tim_val register value
+		uint8_t				offset;			//	Aging_offset register value. 0x08 for no correction
+
+		config();
+	};
 
 	/** Constructor */
 	PCF2131_base();
@@ -179,6 +749,12 @@ public:
 	 */
 	bool oscillator_stop( void );
 
+	/** 100th-seconds register availability
+	 *
+	 * @return true (PCF2131 has 100th-seconds register)
+	 */
+	bool has_hundredths( void );
+
 	/** time
 	 * 
 	 * @return time_t value of current time
@@ -217,6 +793,21 @@ public:
 	 */
 	void alarm_disable( void );
 
+	/** Alarm setting for all digits at once
+	 *
+	 * @param mask digits to be matched. Compose value by ORing MATCH_SECOND, MATCH_MINUTE, MATCH_HOUR, MATCH_DAY and MATCH_WEEKDAY
+	 * @param alarm_tm struct to specify alarm time
+	 */
+	void alarm_match( uint8_t mask, struct tm* alarm_tm );
+
+	/** Alarm setting for all digits at once
+	 *
+	 * @param mask digits to be matched. Compose value by ORing MATCH_SECOND, MATCH_MINUTE, MATCH_HOUR, MATCH_DAY and MATCH_WEEKDAY
+	 * @param alarm_tm struct to specify alarm time
+	 * @param int_sel Interrupt output selector. 0 for INT_A, 1 for INT_B
+	 */
+	void alarm_match( uint8_t mask, struct tm* alarm_tm, int int_sel );
+
 	/** Timestamp setting
 	 *
 	 * @param num timestamp number: 1~4
@@ -253,6 +844,18 @@ public:
 	 */
 	void set_clock_out(clock_out_frequency freq);
 
+	/** Apply configuration
+	 *
+	 *	Reads the configuration registers in two bursts (more if the I2C buffer is small) and writes only the registers which differ from cfg. 
+	 *	Changed registers close to each other are written in one burst. 
+	 *	Nothing is written if the device already has the configuration. 
+	 *	Interrupt flags are not cleared and the STOP bit is not changed. 
+	 *
+	 * @param cfg desired configuration
+	 * @return number of write bursts
+	 */
+	int apply( const config& cfg );
+
 	/** Trigger software reset
 	 */
 	void reset();
@@ -262,6 +865,45 @@ public:
 	void otp_refresh();
 
 protected:
+	/** Read time registers
+	 *
+	 * @param bf pointer to 8 bytes buffer for time register image
+	 */
+	void rtc_time_regs( uint8_t* bf );
+
+	/** Write time registers
+	 *
+	 * @param bf pointer to 8 bytes time register image
+	 */
+	void set_time_regs( uint8_t* bf );
+
+	/** Write time registers with STOP bit set
+	 *
+	 * @param bf pointer to 8 bytes time register image
+	 * @return true
+	 */
+	bool hold_time_regs( uint8_t* bf );
+
+	/** Clear STOP bit */
+	void release_time_regs( void );
+
+	/** OTP refresh and its wait. Called without holding the bus lock */
+	void settle( void );
+
+	/** Read configuration registers into snapshot blob
+	 *
+	 * @param blob pointer to buffer of SNAPSHOT_SIZE bytes
+	 * @return blob size
+	 */
+	uint8_t save_config( uint8_t* blob );
+
+	/** Write configuration registers from snapshot blob
+	 *
+	 * @param blob pointer to blob
+	 * @return false if the blob is not for this type of device
+	 */
+	bool load_config( const uint8_t* blob );
+
 	/** Proxy method for interface  (pure virtual method) */
 	virtual void _reg_w( uint8_t reg, uint8_t *vp, int len )	= 0;
 
@@ -278,21 +920,361 @@ protected:
 	virtual void _bit_op8( uint8_t reg, uint8_t mask, uint8_t val )	= 0;
 
 private:
-	const int int_mask_reg[ 2 ][ 2 ]	= {
-		{ INT_A_MASK1, INT_A_MASK2, },
-		{ INT_B_MASK1, INT_B_MASK2, },
-	};
+	/** Interrupt mask register: INT_A_MASK1/2 for int_sel 0 and INT_B_MASK1/2 for 1. Computed, no table in RAM */
+	static constexpr uint8_t int_mask_reg( int int_sel, int n )
+	{
+		return INT_A_MASK1 + int_sel * 2 + n;
+	}
+
+	/** Register read split in bursts which fit in the I2C buffer */
+	void burst_r( uint8_t reg, uint8_t *vp, int len );
+
+	/** Register write split in bursts which fit in the I2C buffer */
+	void burst_w( uint8_t reg, const uint8_t *vp, int len );
+
+	uint8_t	ctrl1_hold;
 };
 
 
-/** PCF2131_I2C class
+/** RTC_bus_recorder class
  *	
- *	PCF2131 class driver using I2C interface
+ *	Records all register accesses of RTC devices into a compact binary trace.
+ *	The trace is written to a Print stream (Serial, SD file, etc.) record by record, 
+ *	so there is no limit of capture length by RAM size. 
+ *	Accesses through I2C_for_RTC and SPI_for_RTC are recorded while a recorder is started.
  *
- *  @class PCF2131_I2C
+ *	Trace format:
+ *	  header : 'R', 'T', 'C', 'T', version(1)
+ *	  record : type(1), time delta from previous record in microseconds (LEB128 varint), payload
+ *	    'W' register write : device address(1), register(1), length(1), data[length]
+ *	    'R' register read  : device address(1), register(1), length(1), data[length]
+ *	    'T' SPI transfer   : length(1), tx data[length], rx data[length]
+ *	    'M' marker         : id(1)
+ *	    'E' access error   : device address(1), register(1), access type('W' or 'R')(1), status(1)
+ *
+ *	Each try of I2C access is recorded. A failed try is recorded as 'E' without data, 
+ *	so that retries are replayed as those happened. 
+ *	The bit_op8() is recorded as a register read followed by a register write. 
+ *	Length of each access is limited to 255 bytes. 
+ *	Trace can be replayed by RTC_bus_replayer in the Linux host port (extras/host). 
+ *
+ *  @class RTC_bus_recorder
  */
 
-class PCF2131_I2C : public PCF2131_base, public I2C_device
+class RTC_bus_recorder
+{
+public:
+	/** Record type descriptor */
+	enum record_type {
+		REG_WRITE		= 'W',
+		REG_READ		= 'R',
+		SPI_TRANSFER	= 'T',
+		MARKER			= 'M',
+		ACCESS_ERROR	= 'E',
+	};
+	/** Trace format version. Version 1 traces (without 'E' record) can be read too */
+	static const uint8_t	version	= 2;
+
+	/** Create a RTC_bus_recorder instance
+	 *
+	 * @param out stream to write the trace
+	 */
+	RTC_bus_recorder( Print& out );
+
+	/** Destructor */
+	virtual ~RTC_bus_recorder();
+
+	/** Start recording
+	 *
+	 *	Writes the trace header and starts recording. 
+	 *	If another recorder is working, it is stopped. 
+	 */
+	void start( void );
+
+	/** Stop recording */
+	void stop( void );
+
+	/** Put a marker record
+	 *
+	 *	Marker can be used to annotate the trace (e.g. point of failure detection)
+	 *
+	 * @param id marker ID
+	 */
+	void marker( uint8_t id );
+
+	/** Number of records written since start()
+	 *
+	 * @return number of records
+	 */
+	unsigned long records( void );
+
+	/** Recording state
+	 *
+	 * @return true if a recorder is working
+	 */
+	static inline bool recording( void ) { return active; }
+
+	/** Register access recording (called by transport classes)
+	 *
+	 * @param type REG_WRITE or REG_READ
+	 * @param dev device address
+	 * @param reg register index/address/pointer
+	 * @param data pointer to data
+	 * @param size data size
+	 */
+	static void reg_access( uint8_t type, uint8_t dev, uint8_t reg, const uint8_t *data, int size );
+
+	/** Failed register access recording (called by transport classes)
+	 *
+	 * @param type REG_WRITE or REG_READ
+	 * @param dev device address
+	 * @param reg register index/address/pointer
+	 * @param status bus status of the access
+	 */
+	static void access_error( uint8_t type, uint8_t dev, uint8_t reg, uint8_t status );
+
+	/** SPI transfer recording (called by transport classes)
+	 *
+	 * @param tx pointer to sent data
+	 * @param rx pointer to received data
+	 * @param size data size
+	 */
+	static void transfer( const uint8_t *tx, const uint8_t *rx, int size );
+
+private:
+	void	record_head( uint8_t type );
+	void	put( const uint8_t *data, int size );
+
+	static RTC_bus_recorder	*active;
+	Print&			out_stream;
+	unsigned long	last_us;
+	unsigned long	count;
+};
+
+/** I2C_for_RTC class
+ *	
+ *	I2C interface operation for RTC devices. 
+ *	Register access methods of I2C_device are wrapped to be recorded by RTC_bus_recorder
+ *	and to be retried by retry policy. 
+ *
+ *	Each access is tried again on error with doubling interval until the number of retries or the deadline. 
+ *	The deadline bounds the time spent in one access including retries. 
+ *	To bound the time of a hung bus in a single transfer, TwoWire timeout is set to the deadline 
+ *	on cores which support it (WIRE_HAS_TIMEOUT). It is set on first access after construction or retry(), 
+ *	so global instances can be made before TwoWire is ready. 
+ *	The timeout is of the bus, not of a device: the deadline set last is used for all devices on the bus. 
+ *
+ *  @class I2C_for_RTC
+ */
+
+class I2C_for_RTC : public I2C_device
+{
+public:
+	/** Bus access status. 1 to 5 are same as return value of TwoWire::endTransmission() */
+	enum bus_status {
+		BUS_OK				= 0,
+		BUS_DATA_TOO_LONG	= 1,
+		BUS_NACK_ADDRESS	= 2,
+		BUS_NACK_DATA		= 3,
+		BUS_ERROR			= 4,
+		BUS_TIMEOUT			= 5,
+		BUS_DEADLINE		= 6,
+	};
+	/** Retry policy */
+	struct retry_policy {
+		uint8_t		retries;		//	number of retries after first try
+		uint16_t	backoff_us;		//	interval before first retry. doubled on each retry
+		uint16_t	deadline_us;	//	maximum time for an access including retries
+	};
+
+	/** Create a I2C_for_RTC instance with specified address
+	 *
+	 * @param i2c_address I2C-bus address
+	 * @param max_clock maximum SCL frequency of the device
+	 */
+	I2C_for_RTC( uint8_t i2c_address, uint32_t max_clock = 400000 );
+
+	/** Create a I2C_for_RTC instance connected to specified I2C pins with specified address
+	 *
+	 * @param wire TwoWire instance
+	 * @param i2c_address I2C-bus address
+	 * @param max_clock maximum SCL frequency of the device
+	 */
+	I2C_for_RTC( TwoWire& wire, uint8_t i2c_address, uint32_t max_clock = 400000 );
+
+	/** Destructor */
+	virtual ~I2C_for_RTC();
+
+	/** Multiple register write
+	 * 
+	 * @param reg register index/address/pointer
+	 * @param data pointer to data buffer
+	 * @param size data size
+	 * @return transferred data size (0 if failed)
+	 */
+	int reg_w( uint8_t reg_adr, uint8_t *data, uint16_t size );
+
+	/** Single register write
+	 * 
+	 * @param reg_adr register index/address/pointer
+	 * @param data register value
+	 * @return transferred data size (0 if failed)
+	 */
+	int reg_w( uint8_t reg_adr, uint8_t data );
+
+	/** Multiple register read
+	 * 
+	 * @param reg register index/address/pointer
+	 * @param data pointer to data buffer
+	 * @param size data size
+	 * @return transferred data size (0 if failed)
+	 */
+	int reg_r( uint8_t reg_adr, uint8_t *data, uint16_t size );
+
+	/** Single register read
+	 * 
+	 * @param reg register index/address/pointer
+	 * @return read data
+	 */
+	uint8_t	reg_r( uint8_t reg_adr );
+
+	/** Register write, 8 bit
+	 *
+	 * @param reg register index/address/pointer
+	 * @param val data value
+	 */
+	void write_r8( uint8_t reg, uint8_t val );
+
+	/** Register read, 8 bit
+	 *
+	 * @param reg register index/address/pointer
+	 * @return data value
+	 */
+	uint8_t read_r8( uint8_t reg );
+
+	/** Register overwriting with bit-mask
+	 *	
+	 *	Register can be updated by bit level
+	 *
+	 * @param reg register index/address/pointer
+	 * @param mask bit-mask to protect overwriting
+	 * @param value value to overwrite
+	 */
+	void bit_op8(  uint8_t reg,  uint8_t mask,  uint8_t value );
+
+	/** Multiple register write with status
+	 * 
+	 * @param reg register index/address/pointer
+	 * @param data pointer to data buffer
+	 * @param size data size
+	 * @return status
+	 */
+	bus_status try_reg_w( uint8_t reg_adr, const uint8_t *data, uint16_t size );
+
+	/** Multiple register read with status
+	 * 
+	 * @param reg register index/address/pointer
+	 * @param data pointer to data buffer
+	 * @param size data size
+	 * @return status
+	 */
+	bus_status try_reg_r( uint8_t reg_adr, uint8_t *data, uint16_t size );
+
+	/** Register overwriting with bit-mask with status
+	 *
+	 * @param reg register index/address/pointer
+	 * @param mask bit-mask to protect overwriting
+	 * @param value value to overwrite
+	 * @return status
+	 */
+	bus_status try_bit_op8( uint8_t reg, uint8_t mask, uint8_t value );
+
+	/** Set retry policy
+	 *
+	 *	Default is 2 retries, 100 us backoff and 5 ms deadline. 
+	 *	The policy is not copied: give one which is kept while the instance uses it (e.g. static const). 
+	 *	TwoWire timeout is set to the deadline at next access if the core supports it. 
+	 *	It is shared by all devices on the bus. 
+	 *
+	 * @param policy retry policy
+	 */
+	void retry( const retry_policy& policy );
+
+	/** Get retry policy
+	 *
+	 * @return retry policy
+	 */
+	retry_policy retry( void );
+
+	/** Status of last access
+	 *
+	 * @return status of last access
+	 */
+	bus_status status( void );
+
+	/** Number of failed accesses (after retries) since start or last clear_errors(). 0 if RTC_NXP_BUS_STATS is 0 */
+	unsigned long errors( void );
+
+	/** Number of retries done since start or last clear_errors(). 0 if RTC_NXP_BUS_STATS is 0 */
+	unsigned long retries( void );
+
+	/** Clear error and retry counters */
+	void clear_errors( void );
+
+	/** Set bus speed profile
+	 *
+	 *	SCL frequency is set to the profile's frequency or the device maximum, whichever is lower. 
+	 *	Since TwoWire is shared, the setting affects all devices on the bus. 
+	 *	Bus clock is not touched until this method is called. 
+	 *
+	 * @param speed BUS_SPEED_STANDARD, BUS_SPEED_FAST or BUS_SPEED_MAXIMUM
+	 * @param fallback if true, frequency is lowered step by step (1 MHz, 400 kHz, 100 kHz) on each access error before retry
+	 */
+	void bus_profile( RTC_NXP::bus_speed speed, bool fallback = true );
+
+	/** Current SCL frequency set by bus_profile()
+	 *
+	 * @return frequency in Hz (0 if bus_profile() is not called)
+	 */
+	uint32_t bus_clock( void );
+
+	/** Number of fallbacks done. 0 if RTC_NXP_BUS_STATS is 0 */
+	unsigned long fallbacks( void );
+
+private:
+	bus_status	access( uint8_t reg_adr, uint8_t *data, uint16_t size, bool read );
+	bus_status	transfer( uint8_t reg_adr, uint8_t *data, uint16_t size, bool read );
+	void		record( uint8_t reg_adr, const uint8_t *data, uint16_t size, bool read, bus_status rtn );
+	bool		fall_back( void );
+	void		init( void );
+	void		set_timeout( void );
+
+	//	ordered by size to avoid padding on 32 bit MCUs. Clocks are in kHz. 
+	//	TwoWire and target address are of I2C_device (wire and i2c_addr). Policy is shared, not copied
+	const retry_policy	*policy;
+#if RTC_NXP_BUS_STATS
+	unsigned long	error_count;
+	unsigned long	retry_count;
+#endif
+	uint16_t		max_khz;
+	uint16_t		clk_khz;
+#if RTC_NXP_BUS_STATS
+	uint16_t		fallback_count;
+#endif
+	bool			auto_fallback	: 1;
+	bool			timeout_pending	: 1;
+	uint8_t			last_status;
+};
+
+
+/** PCF2131_I2C class
+ *	
+ *	PCF2131 class driver using I2C interface. Fast-mode Plus (1 MHz) can be used by bus_profile()
+ *
+ *  @class PCF2131_I2C
+ */
+
+class PCF2131_I2C : public PCF2131_base, public I2C_for_RTC
 {
 public:
 	/** Create a PCF2131_I2C instance specified address
@@ -359,6 +1341,79 @@ public:
 	 */
 	time_t time( time_t* tp );
 
+	/** now32
+	 *
+	 *	Current time in seconds since 2000-01-01 00:00:00.
+	 *	Converted straight from BCD registers without using "struct tm"
+	 *
+	 * @return uint32_t seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( void );
+
+	/** now32 with 100th-seconds
+	 *
+	 * @param hundredths pointer to store 100th-seconds (0 on devices which don't have 100th-seconds register)
+	 * @return uint32_t seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( uint8_t* hundredths );
+
+	/** 100th-seconds register availability
+	 *
+	 * @return true if the device has 100th-seconds register
+	 */
+	bool has_hundredths( void );
+
+	/** set32
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00 to set calendar and time in RTC
+	 */
+	void set32( uint32_t t );
+
+	/** Load time with the clock stopped
+	 *
+	 *	Time registers are written with STOP bit set and the prescaler cleared. 
+	 *	The clock starts from this time by release(). Used to start RTCs at same instant (see RTC_group)
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00
+	 * @return false if the device has no STOP bit (nothing done)
+	 */
+	bool preload( uint32_t t );
+
+	/** Start the clock stopped by preload(). Done by one register write
+	 */
+	void release( void );
+
+	/** Configuration snapshot
+	 *
+	 *	Configuration registers are read in a few bursts (each fits in the I2C buffer) into a blob of chip tag, data size and register data. 
+	 *	Time registers are not included
+	 *
+	 * @param blob pointer to buffer of SNAPSHOT_SIZE bytes
+	 * @return blob size. 0 if the device is not supported
+	 */
+	uint8_t snapshot( uint8_t* blob );
+
+	/** Restore configuration from snapshot
+	 *
+	 *	Registers are written in a few bursts (each fits in the I2C buffer). 
+	 *	Time registers, STOP bit and reset commands are not written. Interrupt flags are kept as those are
+	 *
+	 * @param blob pointer to blob made by snapshot() on same type of device
+	 * @return false if the blob is not for this type of device
+	 */
+	bool restore( const uint8_t* blob );
+
+	/** ISO 8601 time string
+	 *
+	 *	Writes "YYYY-MM-DDThh:mm:ss" or "YYYY-MM-DDThh:mm:ss.cc" into given buffer.
+	 *	BCD registers are converted into characters directly without binary conversion
+	 *
+	 * @param s pointer to char buffer. 20 bytes needed, 23 bytes with hundredths
+	 * @param hundredths appending ".cc" if true. It will be ".00" on devices which don't have 100th-seconds register
+	 * @return pointer to the string
+	 */
+	char* iso8601( char* s, bool hundredths = false );
+
 	/** Initializer
 	 * Just clears pending interrupt
 	 */
@@ -408,6 +1463,29 @@ public:
 	 */
 	void alarm_disable( void );
 
+	/** Alarm setting for all digits at once
+	 *
+	 * @param mask digits to be matched. Compose value by ORing MATCH_SECOND, MATCH_MINUTE, MATCH_HOUR, MATCH_DAY and MATCH_WEEKDAY
+	 * @param alarm_tm struct to specify alarm time
+	 */
+	void alarm_match( uint8_t mask, struct tm* alarm_tm );
+
+	/** Alarm setting for all digits at once
+	 *
+	 * @param mask digits to be matched. Compose value by ORing MATCH_SECOND, MATCH_MINUTE, MATCH_HOUR, MATCH_DAY and MATCH_WEEKDAY
+	 * @param alarm_tm struct to specify alarm time
+	 * @param int_sel Interrupt output selector. 0 for INT_A, 1 for INT_B
+	 */
+	void alarm_match( uint8_t mask, struct tm* alarm_tm, int int_sel );
+
+	/** Alarm setting by time_t
+	 * 
+	 *	Sets alarm matching to second, minute, hour and day of given time
+	 *
+	 * @param t alarm time
+	 */
+	void alarm_at( time_t t );
+
 	/** Timestamp setting
 	 *
 	 * @param num timestamp number: 1~4
@@ -444,6 +1522,18 @@ public:
 	 */
 	void set_clock_out(clock_out_frequency freq);
 
+	/** Apply configuration
+	 *
+	 *	Reads the configuration registers in two bursts (more if the I2C buffer is small) and writes only the registers which differ from cfg. 
+	 *	Changed registers close to each other are written in one burst. 
+	 *	Nothing is written if the device already has the configuration. 
+	 *	Interrupt flags are not cleared and the STOP bit is not changed. 
+	 *
+	 * @param cfg desired configuration
+	 * @return number of write bursts
+	 */
+	int apply( const config& cfg );
+
 	/** Trigger software reset
 	 */
 	void reset();
@@ -536,6 +1626,28 @@ private:
 class SPI_for_RTC
 {
 public:
+	/** Create a SPI_for_RTC instance
+	 *
+	 * @param max_clock maximum SCK frequency of the device
+	 */
+	SPI_for_RTC( uint32_t max_clock = 4000000 );
+
+	/** Set bus speed profile
+	 *
+	 *	SCK frequency is set to the profile's frequency or the device maximum, whichever is lower. 
+	 *	After this call, each transfer is done in SPI.beginTransaction()/endTransaction() with the setting. 
+	 *	SPI has no acknowledge, so no fallback is done on errors. 
+	 *
+	 * @param speed BUS_SPEED_STANDARD, BUS_SPEED_FAST or BUS_SPEED_MAXIMUM
+	 */
+	void bus_profile( RTC_NXP::bus_speed speed );
+
+	/** Current SCK frequency set by bus_profile()
+	 *
+	 * @return frequency in Hz (0 if bus_profile() is not called)
+	 */
+	uint32_t bus_clock( void );
+
 	/** Send data
 	 *
 	 * @param data pointer to data buffer
@@ -596,6 +1708,25 @@ public:
 	 * @param value value to overwrite
 	 */
 	void bit_op8(  uint8_t reg,  uint8_t mask,  uint8_t value );
+
+private:
+	void transfer( uint8_t *data, int size );
+
+	/** Register access in one chip-select period
+	 *
+	 *	Command byte and data are sent from separate buffers, no copy is made to build a frame
+	 *
+	 * @param cmd command byte (register address with read flag)
+	 * @param tx data to be sent. 0xFF is sent if NULL
+	 * @param rx buffer for received data. Discarded if NULL
+	 * @param size data size
+	 */
+	void frame( uint8_t cmd, const uint8_t *tx, uint8_t *rx, int size );
+	void frame_transfer( uint8_t cmd, const uint8_t *tx, uint8_t *rx, int size );
+
+	SPISettings	settings;
+	uint16_t	max_khz;	//	clocks are in kHz
+	uint16_t	clk_khz;
 };
 
 /** PCF2131_SPI class
@@ -608,7 +1739,7 @@ public:
 class PCF2131_SPI : public PCF2131_base, public SPI_for_RTC
 {
 public:
-	/** Create a PCF2131_SPI instance */
+	/** Create a PCF2131_SPI instance (maximum SCK frequency is 6.5 MHz) */
 	PCF2131_SPI();
 
 	/** Destructor */
@@ -662,6 +1793,79 @@ public:
 	 */
 	time_t time( time_t* tp );
 
+	/** now32
+	 *
+	 *	Current time in seconds since 2000-01-01 00:00:00.
+	 *	Converted straight from BCD registers without using "struct tm"
+	 *
+	 * @return uint32_t seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( void );
+
+	/** now32 with 100th-seconds
+	 *
+	 * @param hundredths pointer to store 100th-seconds (0 on devices which don't have 100th-seconds register)
+	 * @return uint32_t seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( uint8_t* hundredths );
+
+	/** 100th-seconds register availability
+	 *
+	 * @return true if the device has 100th-seconds register
+	 */
+	bool has_hundredths( void );
+
+	/** set32
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00 to set calendar and time in RTC
+	 */
+	void set32( uint32_t t );
+
+	/** Load time with the clock stopped
+	 *
+	 *	Time registers are written with STOP bit set and the prescaler cleared. 
+	 *	The clock starts from this time by release(). Used to start RTCs at same instant (see RTC_group)
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00
+	 * @return false if the device has no STOP bit (nothing done)
+	 */
+	bool preload( uint32_t t );
+
+	/** Start the clock stopped by preload(). Done by one register write
+	 */
+	void release( void );
+
+	/** Configuration snapshot
+	 *
+	 *	Configuration registers are read in a few bursts (each fits in the I2C buffer) into a blob of chip tag, data size and register data. 
+	 *	Time registers are not included
+	 *
+	 * @param blob pointer to buffer of SNAPSHOT_SIZE bytes
+	 * @return blob size. 0 if the device is not supported
+	 */
+	uint8_t snapshot( uint8_t* blob );
+
+	/** Restore configuration from snapshot
+	 *
+	 *	Registers are written in a few bursts (each fits in the I2C buffer). 
+	 *	Time registers, STOP bit and reset commands are not written. Interrupt flags are kept as those are
+	 *
+	 * @param blob pointer to blob made by snapshot() on same type of device
+	 * @return false if the blob is not for this type of device
+	 */
+	bool restore( const uint8_t* blob );
+
+	/** ISO 8601 time string
+	 *
+	 *	Writes "YYYY-MM-DDThh:mm:ss" or "YYYY-MM-DDThh:mm:ss.cc" into given buffer.
+	 *	BCD registers are converted into characters directly without binary conversion
+	 *
+	 * @param s pointer to char buffer. 20 bytes needed, 23 bytes with hundredths
+	 * @param hundredths appending ".cc" if true. It will be ".00" on devices which don't have 100th-seconds register
+	 * @return pointer to the string
+	 */
+	char* iso8601( char* s, bool hundredths = false );
+
 	/** Initializer
 	 * Just clears pending interrupt
 	 */
@@ -711,9 +1915,32 @@ public:
 	 */
 	void alarm_disable( void );
 
-	/** Timestamp setting
+	/** Alarm setting for all digits at once
 	 *
-	 * @param num timestamp number: 1~4
+	 * @param mask digits to be matched. Compose value by ORing MATCH_SECOND, MATCH_MINUTE, MATCH_HOUR, MATCH_DAY and MATCH_WEEKDAY
+	 * @param alarm_tm struct to specify alarm time
+	 */
+	void alarm_match( uint8_t mask, struct tm* alarm_tm );
+
+	/** Alarm setting for all digits at once
+	 *
+	 * @param mask digits to be matched. Compose value by ORing MATCH_SECOND, MATCH_MINUTE, MATCH_HOUR, MATCH_DAY and MATCH_WEEKDAY
+	 * @param alarm_tm struct to specify alarm time
+	 * @param int_sel Interrupt output selector. 0 for INT_A, 1 for INT_B
+	 */
+	void alarm_match( uint8_t mask, struct tm* alarm_tm, int int_sel );
+
+	/** Alarm setting by time_t
+	 * 
+	 *	Sets alarm matching to second, minute, hour and day of given time
+	 *
+	 * @param t alarm time
+	 */
+	void alarm_at( time_t t );
+
+	/** Timestamp setting
+	 *
+	 * @param num timestamp number: 1~4
 	 * @param ts_setting event recording option. Choose LAST or FIRST in 'enum timestamp_setting'
 	 * @param int_sel Interrupt output selector. 0 for INT_A, 1 for INT_B
 	 */
@@ -747,6 +1974,18 @@ public:
 	 */
 	void set_clock_out(clock_out_frequency freq);
 
+	/** Apply configuration
+	 *
+	 *	Reads the configuration registers in two bursts (more if the I2C buffer is small) and writes only the registers which differ from cfg. 
+	 *	Changed registers close to each other are written in one burst. 
+	 *	Nothing is written if the device already has the configuration. 
+	 *	Interrupt flags are not cleared and the STOP bit is not changed. 
+	 *
+	 * @param cfg desired configuration
+	 * @return number of write bursts
+	 */
+	int apply( const config& cfg );
+
 	/** Trigger software reset
 	 */
 	void reset();
@@ -795,6 +2034,12 @@ public:
 		Second_alarm, Minute_alarm, Hour_alarm, Day_alarm, Weekday_alarm,
 		Timer_value, Timer_mode
 	};
+	/** Periodic interrupt selection descriptor */
+	enum periodic_int_select {
+		DISABLE,
+		EVERY_MINUTE,
+		EVERY_HALF_MINUTE,
+	};
 	
 	/** Constructor */
 	PCF85063_base();
@@ -834,10 +2079,32 @@ public:
 	 */
 	void alarm_disable( void );
 
+	/** Alarm setting for all digits at once
+	 *
+	 * @param mask digits to be matched. Compose value by ORing MATCH_SECOND, MATCH_MINUTE, MATCH_HOUR, MATCH_DAY and MATCH_WEEKDAY
+	 * @param alarm_tm struct to specify alarm time
+	 */
+	void alarm_match( uint8_t mask, struct tm* alarm_tm );
+
 	/** Interrupt clear
 	 */
 	uint8_t int_clear( void );
 
+	/** Enabling every minute/half-minute interrupt
+	 *
+	 *	Interrupt is given at the minute (and half-minute) boundary on INT pin. 
+	 *	The interrupt flag (TF) is kept set until it is cleared by int_clear()
+	 *
+	 * @param sel choose DISABLE, EVERY_MINUTE or EVERY_HALF_MINUTE in 'enum periodic_int_select'
+	 */
+	void periodic_interrupt_enable( periodic_int_select sel );
+
+	/** Set clock output (CLKOUT)
+	 *
+	 * @param freq choose desired clock output (CLKOUT) frequency in 'enum clock_out_frequency'
+	 */
+	void set_clock_out( clock_out_frequency freq );
+
 	
 	/** Timer setting
 	 *
@@ -854,6 +2121,42 @@ protected:
 	 */
 	time_t rtc_time( void );
 
+	/** Read time registers
+	 *
+	 * @param bf pointer to 8 bytes buffer for time register image
+	 */
+	void rtc_time_regs( uint8_t* bf );
+
+	/** Write time registers
+	 *
+	 * @param bf pointer to 8 bytes time register image
+	 */
+	void set_time_regs( uint8_t* bf );
+
+	/** Write time registers with STOP bit set
+	 *
+	 * @param bf pointer to 8 bytes time register image
+	 * @return true
+	 */
+	bool hold_time_regs( uint8_t* bf );
+
+	/** Clear STOP bit */
+	void release_time_regs( void );
+
+	/** Read configuration registers into snapshot blob
+	 *
+	 * @param blob pointer to buffer of SNAPSHOT_SIZE bytes
+	 * @return blob size
+	 */
+	uint8_t save_config( uint8_t* blob );
+
+	/** Write configuration registers from snapshot blob
+	 *
+	 * @param blob pointer to blob
+	 * @return false if the blob is not for this type of device
+	 */
+	bool load_config( const uint8_t* blob );
+
 	/** Proxy method for interface  (pure virtual method) */
 	virtual void _reg_w( uint8_t reg, uint8_t *vp, int len )	= 0;
 
@@ -868,9 +2171,12 @@ protected:
 
 	/** Proxy method for interface  (pure virtual method) */
 	virtual void _bit_op8( uint8_t reg, uint8_t mask, uint8_t val )	= 0;
+
+private:
+	uint8_t	ctrl1_hold;
 };
 
-class PCF85063A : public PCF85063_base, public I2C_device
+class PCF85063A : public PCF85063_base, public I2C_for_RTC
 {
 public:
 	/** Create a PCF85063A instance with specified address
@@ -899,6 +2205,12 @@ public:
 		Second_alarm, Minute_alarm, Hour_alarm, Day_alarm, Weekday_alarm,
 		Timer_value, Timer_mode
 	};
+	/** Periodic interrupt selection descriptor */
+	enum periodic_int_select {
+		DISABLE,
+		EVERY_MINUTE,
+		EVERY_HALF_MINUTE,
+	};
 
 	/** time
 	 * 
@@ -909,6 +2221,79 @@ public:
 	 */
 	time_t time( time_t* tp );
 
+	/** now32
+	 *
+	 *	Current time in seconds since 2000-01-01 00:00:00.
+	 *	Converted straight from BCD registers without using "struct tm"
+	 *
+	 * @return uint32_t seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( void );
+
+	/** now32 with 100th-seconds
+	 *
+	 * @param hundredths pointer to store 100th-seconds (0 on devices which don't have 100th-seconds register)
+	 * @return uint32_t seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( uint8_t* hundredths );
+
+	/** 100th-seconds register availability
+	 *
+	 * @return true if the device has 100th-seconds register
+	 */
+	bool has_hundredths( void );
+
+	/** set32
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00 to set calendar and time in RTC
+	 */
+	void set32( uint32_t t );
+
+	/** Load time with the clock stopped
+	 *
+	 *	Time registers are written with STOP bit set and the prescaler cleared. 
+	 *	The clock starts from this time by release(). Used to start RTCs at same instant (see RTC_group)
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00
+	 * @return false if the device has no STOP bit (nothing done)
+	 */
+	bool preload( uint32_t t );
+
+	/** Start the clock stopped by preload(). Done by one register write
+	 */
+	void release( void );
+
+	/** Configuration snapshot
+	 *
+	 *	Configuration registers are read in a few bursts (each fits in the I2C buffer) into a blob of chip tag, data size and register data. 
+	 *	Time registers are not included
+	 *
+	 * @param blob pointer to buffer of SNAPSHOT_SIZE bytes
+	 * @return blob size. 0 if the device is not supported
+	 */
+	uint8_t snapshot( uint8_t* blob );
+
+	/** Restore configuration from snapshot
+	 *
+	 *	Registers are written in a few bursts (each fits in the I2C buffer). 
+	 *	Time registers, STOP bit and reset commands are not written. Interrupt flags are kept as those are
+	 *
+	 * @param blob pointer to blob made by snapshot() on same type of device
+	 * @return false if the blob is not for this type of device
+	 */
+	bool restore( const uint8_t* blob );
+
+	/** ISO 8601 time string
+	 *
+	 *	Writes "YYYY-MM-DDThh:mm:ss" or "YYYY-MM-DDThh:mm:ss.cc" into given buffer.
+	 *	BCD registers are converted into characters directly without binary conversion
+	 *
+	 * @param s pointer to char buffer. 20 bytes needed, 23 bytes with hundredths
+	 * @param hundredths appending ".cc" if true. It will be ".00" on devices which don't have 100th-seconds register
+	 * @return pointer to the string
+	 */
+	char* iso8601( char* s, bool hundredths = false );
+
 	/** Initializer but nothing done with this method in this version. 
 	 * Don't need to call
 	 */
@@ -941,10 +2326,40 @@ public:
 	 */
 	void alarm_disable( void );
 
+	/** Alarm setting for all digits at once
+	 *
+	 * @param mask digits to be matched. Compose value by ORing MATCH_SECOND, MATCH_MINUTE, MATCH_HOUR, MATCH_DAY and MATCH_WEEKDAY
+	 * @param alarm_tm struct to specify alarm time
+	 */
+	void alarm_match( uint8_t mask, struct tm* alarm_tm );
+
+	/** Alarm setting by time_t
+	 * 
+	 *	Sets alarm matching to second, minute, hour and day of given time
+	 *
+	 * @param t alarm time
+	 */
+	void alarm_at( time_t t );
+
 	/** Interrupt clear
 	 */
 	uint8_t int_clear( void );
 
+	/** Enabling every minute/half-minute interrupt
+	 *
+	 *	Interrupt is given at the minute (and half-minute) boundary on INT pin. 
+	 *	The interrupt flag (TF) is kept set until it is cleared by int_clear()
+	 *
+	 * @param sel choose DISABLE, EVERY_MINUTE or EVERY_HALF_MINUTE in 'enum periodic_int_select'
+	 */
+	void periodic_interrupt_enable( periodic_int_select sel );
+
+	/** Set clock output (CLKOUT)
+	 *
+	 * @param freq choose desired clock output (CLKOUT) frequency in 'enum clock_out_frequency'
+	 */
+	void set_clock_out( clock_out_frequency freq );
+
 	
 	/** Timer setting
 	 *
@@ -1046,6 +2461,13 @@ public:
 	/** Destructor */
 	virtual ~PCF85063TP();
 	
+	/** No periodic interrupt on PCF85063TP: it has no INT output (Control_2 has COF only). 
+	 *	This method only shows a warning
+	 *
+	 * @param sel ignored
+	 */
+	void periodic_interrupt_enable( periodic_int_select sel );
+
 #if DOXYGEN_ONLY
 	/** Name of the PCF85063TP registers */
 	enum reg_num {
@@ -1062,6 +2484,79 @@ public:
 	 * @return time_t value of current time
 	 */
 	time_t time( time_t* tp );
+
+	/** now32
+	 *
+	 *	Current time in seconds since 2000-01-01 00:00:00.
+	 *	Converted straight from BCD registers without using "struct tm"
+	 *
+	 * @return uint32_t seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( void );
+
+	/** now32 with 100th-seconds
+	 *
+	 * @param hundredths pointer to store 100th-seconds (0 on devices which don't have 100th-seconds register)
+	 * @return uint32_t seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( uint8_t* hundredths );
+
+	/** 100th-seconds register availability
+	 *
+	 * @return true if the device has 100th-seconds register
+	 */
+	bool has_hundredths( void );
+
+	/** set32
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00 to set calendar and time in RTC
+	 */
+	void set32( uint32_t t );
+
+	/** Load time with the clock stopped
+	 *
+	 *	Time registers are written with STOP bit set and the prescaler cleared. 
+	 *	The clock starts from this time by release(). Used to start RTCs at same instant (see RTC_group)
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00
+	 * @return false if the device has no STOP bit (nothing done)
+	 */
+	bool preload( uint32_t t );
+
+	/** Start the clock stopped by preload(). Done by one register write
+	 */
+	void release( void );
+
+	/** Configuration snapshot
+	 *
+	 *	Configuration registers are read in a few bursts (each fits in the I2C buffer) into a blob of chip tag, data size and register data. 
+	 *	Time registers are not included
+	 *
+	 * @param blob pointer to buffer of SNAPSHOT_SIZE bytes
+	 * @return blob size. 0 if the device is not supported
+	 */
+	uint8_t snapshot( uint8_t* blob );
+
+	/** Restore configuration from snapshot
+	 *
+	 *	Registers are written in a few bursts (each fits in the I2C buffer). 
+	 *	Time registers, STOP bit and reset commands are not written. Interrupt flags are kept as those are
+	 *
+	 * @param blob pointer to blob made by snapshot() on same type of device
+	 * @return false if the blob is not for this type of device
+	 */
+	bool restore( const uint8_t* blob );
+
+	/** ISO 8601 time string
+	 *
+	 *	Writes "YYYY-MM-DDThh:mm:ss" or "YYYY-MM-DDThh:mm:ss.cc" into given buffer.
+	 *	BCD registers are converted into characters directly without binary conversion
+	 *
+	 * @param s pointer to char buffer. 20 bytes needed, 23 bytes with hundredths
+	 * @param hundredths appending ".cc" if true. It will be ".00" on devices which don't have 100th-seconds register
+	 * @return pointer to the string
+	 */
+	char* iso8601( char* s, bool hundredths = false );
 	
 	/** Initializer but nothing done with this method in this version. 
 	 * Don't need to call
@@ -1079,6 +2574,12 @@ public:
 	 * @return true, if the OSF (Oscillator Stop Flag) is set
 	 */
 	bool oscillator_stop( void );
+
+	/** Set clock output (CLKOUT)
+	 *
+	 * @param freq choose desired clock output (CLKOUT) frequency in 'enum clock_out_frequency'
+	 */
+	void set_clock_out( clock_out_frequency freq );
 	
 	/** Multiple register write
 	 * 
@@ -1136,9 +2637,23 @@ public:
 
 #endif	//	DOXYGEN_ONLY
 
+protected:
+	/** Read configuration registers into snapshot blob
+	 *
+	 * @param blob pointer to buffer of SNAPSHOT_SIZE bytes
+	 * @return blob size
+	 */
+	uint8_t save_config( uint8_t* blob );
+
+	/** Write configuration registers from snapshot blob
+	 *
+	 * @param blob pointer to blob
+	 * @return false if the blob is not for this type of device
+	 */
+	bool load_config( const uint8_t* blob );
 };
 
-class PCF85263A : public RTC_NXP, public I2C_device
+class PCF85263A : public RTC_NXP, public I2C_for_RTC
 {
 public:
 	/** Name of the PCF85263A registers */
@@ -1240,6 +2755,12 @@ public:
 	 * @return true, if the OSF (Oscillator Stop Flag) is set
 	 */
 	bool oscillator_stop( void );
+
+	/** 100th-seconds register availability
+	 *
+	 * @return true (PCF85263A has 100th-seconds register)
+	 */
+	bool has_hundredths( void );
 	
 	/** Alarm setting
 	 * 
@@ -1272,10 +2793,33 @@ public:
 	 */
 	void alarm_disable( void );
 
+	/** Alarm setting for all digits at once
+	 *
+	 * @param mask digits to be matched. Compose value by ORing MATCH_SECOND, MATCH_MINUTE, MATCH_HOUR and MATCH_DAY. MATCH_WEEKDAY is unsupported: a message is shown and nothing is set
+	 * @param alarm_tm struct to specify alarm time
+	 */
+	void alarm_match( uint8_t mask, struct tm* alarm_tm );
+
+	/** Alarm setting for all digits at once
+	 *
+	 * @param mask digits to be matched. Compose value by ORing MATCH_SECOND, MATCH_MINUTE, MATCH_HOUR and MATCH_DAY. MATCH_WEEKDAY is unsupported: a message is shown and nothing is set
+	 * @param alarm_tm struct to specify alarm time
+	 * @param int_sel Interrupt output selector. 0 for INT_A, 1 for INT_B
+	 */
+	void alarm_match( uint8_t mask, struct tm* alarm_tm, int int_sel );
+
 	/** Interrupt clear
 	 */
 	uint8_t int_clear( void );
 
+	/** Set clock output (CLKOUT)
+	 *
+	 *	The clock is output on INT_A or INT_B pin which is configured to CLKOUT by pin_config()
+	 *
+	 * @param freq choose desired clock output (CLKOUT) frequency in 'enum clock_out_frequency'
+	 */
+	void set_clock_out( clock_out_frequency freq );
+
 	/** rtc_time
 	 * 
 	 * @return time_t returns RTC time in time_t format
@@ -1317,6 +2861,81 @@ public:
 	 * @return time_t value of current time
 	 */
 	time_t time( time_t* tp );
+
+	/** now32
+	 *
+	 *	Current time in seconds since 2000-01-01 00:00:00.
+	 *	Converted straight from BCD registers without using "struct tm"
+	 *
+	 * @return uint32_t seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( void );
+
+	/** now32 with 100th-seconds
+	 *
+	 * @param hundredths pointer to store 100th-seconds (0 on devices which don't have 100th-seconds register)
+	 * @return uint32_t seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( uint8_t* hundredths );
+
+	/** set32
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00 to set calendar and time in RTC
+	 */
+	void set32( uint32_t t );
+
+	/** Load time with the clock stopped
+	 *
+	 *	Time registers are written with STOP bit set and the prescaler cleared. 
+	 *	The clock starts from this time by release(). Used to start RTCs at same instant (see RTC_group)
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00
+	 * @return false if the device has no STOP bit (nothing done)
+	 */
+	bool preload( uint32_t t );
+
+	/** Start the clock stopped by preload(). Done by one register write
+	 */
+	void release( void );
+
+	/** Configuration snapshot
+	 *
+	 *	Configuration registers are read in a few bursts (each fits in the I2C buffer) into a blob of chip tag, data size and register data. 
+	 *	Time registers are not included
+	 *
+	 * @param blob pointer to buffer of SNAPSHOT_SIZE bytes
+	 * @return blob size. 0 if the device is not supported
+	 */
+	uint8_t snapshot( uint8_t* blob );
+
+	/** Restore configuration from snapshot
+	 *
+	 *	Registers are written in a few bursts (each fits in the I2C buffer). 
+	 *	Time registers, STOP bit and reset commands are not written. Interrupt flags are kept as those are
+	 *
+	 * @param blob pointer to blob made by snapshot() on same type of device
+	 * @return false if the blob is not for this type of device
+	 */
+	bool restore( const uint8_t* blob );
+
+	/** ISO 8601 time string
+	 *
+	 *	Writes "YYYY-MM-DDThh:mm:ss" or "YYYY-MM-DDThh:mm:ss.cc" into given buffer.
+	 *	BCD registers are converted into characters directly without binary conversion
+	 *
+	 * @param s pointer to char buffer. 20 bytes needed, 23 bytes with hundredths
+	 * @param hundredths appending ".cc" if true. It will be ".00" on devices which don't have 100th-seconds register
+	 * @return pointer to the string
+	 */
+	char* iso8601( char* s, bool hundredths = false );
+
+	/** Alarm setting by time_t
+	 * 
+	 *	Sets alarm matching to second, minute, hour and day of given time
+	 *
+	 * @param t alarm time
+	 */
+	void alarm_at( time_t t );
 	
 	/** Multiple register write
 	 * 
@@ -1374,11 +2993,48 @@ public:
 
 #endif	//	DOXYGEN_ONLY
 
+protected:
+	/** Read time registers
+	 *
+	 * @param bf pointer to 8 bytes buffer for time register image
+	 */
+	void rtc_time_regs( uint8_t* bf );
+
+	/** Write time registers
+	 *
+	 * @param bf pointer to 8 bytes time register image
+	 */
+	void set_time_regs( uint8_t* bf );
+
+	/** Write time registers with STOP bit set
+	 *
+	 * @param bf pointer to 8 bytes time register image
+	 * @return true
+	 */
+	bool hold_time_regs( uint8_t* bf );
+
+	/** Clear STOP bit */
+	void release_time_regs( void );
+
+	/** Read configuration registers into snapshot blob
+	 *
+	 * @param blob pointer to buffer of SNAPSHOT_SIZE bytes
+	 * @return blob size
+	 */
+	uint8_t save_config( uint8_t* blob );
+
+	/** Write configuration registers from snapshot blob
+	 *
+	 * @param blob pointer to blob
+	 * @return false if the blob is not for this type of device
+	 */
+	bool load_config( const uint8_t* blob );
+
 private:
 	void set_alarm( int digit, int val, int int_sel );
 };
 
-class PCF85053A : public RTC_NXP, public I2C_device
+class PCF85053A : public RTC_NXP, public I2C_for_RTC
 {
 public:
 	/** Name of the PCF85053A registers */
@@ -1444,10 +3100,23 @@ public:
 	 */
 	void alarm_disable( void );
 
+	/** Alarm setting for all digits at once
+	 *
+	 * @param mask digits to be matched. Compose value by ORing MATCH_SECOND, MATCH_MINUTE and MATCH_HOUR. MATCH_DAY and MATCH_WEEKDAY are ignored
+	 * @param alarm_tm struct to specify alarm time
+	 */
+	void alarm_match( uint8_t mask, struct tm* alarm_tm );
+
 	/** Interrupt clear
 	 */
 	uint8_t int_clear( void );
 
+	/** Set clock output (CLKOUT)
+	 *
+	 * @param freq choose desired clock output (CLKOUT) frequency in 'enum clock_out_frequency'. FREQ_32768_HZ, FREQ_1024_HZ, FREQ_1_HZ or FREQ_DISABLE is available
+	 */
+	void set_clock_out( clock_out_frequency freq );
+
 	/** rtc_time
 	 * 
 	 * @return time_t returns RTC time in time_t format
@@ -1463,6 +3132,87 @@ public:
 	 * @return time_t value of current time
 	 */
 	time_t time( time_t* tp );
+
+	/** now32
+	 *
+	 *	Current time in seconds since 2000-01-01 00:00:00.
+	 *	Converted straight from BCD registers without using "struct tm"
+	 *
+	 * @return uint32_t seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( void );
+
+	/** now32 with 100th-seconds
+	 *
+	 * @param hundredths pointer to store 100th-seconds (0 on devices which don't have 100th-seconds register)
+	 * @return uint32_t seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( uint8_t* hundredths );
+
+	/** 100th-seconds register availability
+	 *
+	 * @return true if the device has 100th-seconds register
+	 */
+	bool has_hundredths( void );
+
+	/** set32
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00 to set calendar and time in RTC
+	 */
+	void set32( uint32_t t );
+
+	/** Load time with the clock stopped
+	 *
+	 *	Time registers are written with STOP bit set and the prescaler cleared. 
+	 *	The clock starts from this time by release(). Used to start RTCs at same instant (see RTC_group)
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00
+	 * @return false if the device has no STOP bit (nothing done)
+	 */
+	bool preload( uint32_t t );
+
+	/** Start the clock stopped by preload(). Done by one register write
+	 */
+	void release( void );
+
+	/** Configuration snapshot
+	 *
+	 *	Configuration registers are read in a few bursts (each fits in the I2C buffer) into a blob of chip tag, data size and register data. 
+	 *	Time registers are not included
+	 *
+	 * @param blob pointer to buffer of SNAPSHOT_SIZE bytes
+	 * @return blob size. 0 if the device is not supported
+	 */
+	uint8_t snapshot( uint8_t* blob );
+
+	/** Restore configuration from snapshot
+	 *
+	 *	Registers are written in a few bursts (each fits in the I2C buffer). 
+	 *	Time registers, STOP bit and reset commands are not written. Interrupt flags are kept as those are
+	 *
+	 * @param blob pointer to blob made by snapshot() on same type of device
+	 * @return false if the blob is not for this type of device
+	 */
+	bool restore( const uint8_t* blob );
+
+	/** ISO 8601 time string
+	 *
+	 *	Writes "YYYY-MM-DDThh:mm:ss" or "YYYY-MM-DDThh:mm:ss.cc" into given buffer.
+	 *	BCD registers are converted into characters directly without binary conversion
+	 *
+	 * @param s pointer to char buffer. 20 bytes needed, 23 bytes with hundredths
+	 * @param hundredths appending ".cc" if true. It will be ".00" on devices which don't have 100th-seconds register
+	 * @return pointer to the string
+	 */
+	char* iso8601( char* s, bool hundredths = false );
+
+	/** Alarm setting by time_t
+	 * 
+	 *	Sets alarm matching to second, minute, hour and day of given time
+	 *
+	 * @param t alarm time
+	 */
+	void alarm_at( time_t t );
 	
 	/** Multiple register write
 	 * 
@@ -1520,12 +3270,877 @@ public:
 
 #endif	//	DOXYGEN_ONLY
 	
+protected:
+	/** Read time registers
+	 *
+	 * @param bf pointer to 8 bytes buffer for time register image
+	 */
+	void rtc_time_regs( uint8_t* bf );
+
+	/** Write time registers
+	 *
+	 * @param bf pointer to 8 bytes time register image
+	 */
+	void set_time_regs( uint8_t* bf );
+
+	/** Read configuration registers into snapshot blob
+	 *
+	 * @param blob pointer to buffer of SNAPSHOT_SIZE bytes
+	 * @return blob size
+	 */
+	uint8_t save_config( uint8_t* blob );
+
+	/** Write configuration registers from snapshot blob
+	 *
+	 * @param blob pointer to blob
+	 * @return false if the blob is not for this type of device
+	 */
+	bool load_config( const uint8_t* blob );
+
+private:
+	/** Alarm register of SECOND, MINUTE or HOUR: placed next to each time register. Computed, no table in RAM */
+	static constexpr uint8_t alarm_reg( int digit )
+	{
+		return Seconds_alarm + digit * 2;
+	}
+};
+
+/** RTC_timebase class
+ *	
+ *	Tick service on RTC periodic interrupt (every second, half-minute or minute).
+ *	Each interrupt edge is timestamped by micros() in ISR. 
+ *	Jitter of edge interval and latency from the edge to the service are measured.
+ *	Tick count is aligned to RTC time, so callbacks happen on same RTC second on every node
+ *
+ *  @class RTC_timebase
+ */
+
+class RTC_timebase
+{
+public:
+	/** Callback function type. RTC time (seconds since 2000-01-01 00:00:00) of the tick is given */
+	typedef void (*callback_t)( uint32_t t );
+
+	/** Create a RTC_timebase instance
+	 *
+	 * @param rtc RTC instance generating periodic interrupt
+	 * @param period interrupt period in second (default: 1). Set 60 for every minute interrupt, 30 for every half-minute interrupt
+	 */
+	RTC_timebase( RTC_NXP& rtc, uint8_t period = 1 );
+
+	/** Destructor */
+	virtual ~RTC_timebase();
+
+	/** Start the service
+	 *	Clears statistics. Tick count will be aligned to RTC time at next tick
+	 */
+	void begin( void );
+
+	/** Interrupt edge notification. Call this from ISR
+	 */
+	void edge( void );
+
+	/** Service. Call this from loop()
+	 *
+	 * @return true, if a tick has been processed
+	 */
+	bool update( void );
+
+	/** Callback setting
+	 *
+	 *	Callback is called at the first tick at or after each RTC time which meets (t % interval) == phase. 
+	 *	If the phase is not a multiple of the tick period, the callback comes at next tick with its RTC time. 
+	 *	If several callback times are passed while update() is not called, the callback is called once
+	 *
+	 * @param cb callback function
+	 * @param interval callback interval in second (default: 1). 0 is taken as 1
+	 * @param phase callback phase in second (default: 0). Taken modulo interval
+	 */
+	void callback( callback_t cb, uint16_t interval = 1, uint16_t phase = 0 );
+
+	/** Re-align tick count to RTC time at next tick. Use this after RTC time setting
+	 */
+	void resync( void );
+
+	/** Number of processed ticks
+	 *
+	 * @return tick count
+	 */
+	uint32_t ticks( void );
+
+	/** RTC time of last tick
+	 *
+	 * @return seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( void );
+
+	/** micros() at the edge of last tick
+	 *
+	 * @return micros() value
+	 */
+	unsigned long edge_micros( void );
+
+	/** Number of edges which were not serviced in time
+	 *
+	 * @return missed edge count
+	 */
+	uint16_t missed( void );
+
+	/** Minimum jitter: deviation of edge interval from the period
+	 *
+	 * @return jitter in microseconds
+	 */
+	long jitter_min( void );
+
+	/** Maximum jitter: deviation of edge interval from the period
+	 *
+	 * @return jitter in microseconds
+	 */
+	long jitter_max( void );
+
+	/** RMS jitter: deviation of edge interval from the period
+	 *
+	 * @return jitter in microseconds
+	 */
+	float jitter_rms( void );
+
+	/** Maximum latency: time from the edge to the service in update()
+	 *
+	 * @return latency in microseconds
+	 */
+	unsigned long latency_max( void );
+
+	/** Mean latency: time from the edge to the service in update()
+	 *
+	 * @return latency in microseconds
+	 */
+	float latency_mean( void );
+
+	/** Statistics clearing
+	 */
+	void reset_statistics( void );
+
 private:
-	//static inline constexpr uint8_t alarm_offsets[]	= { 1, 3, 5 };
-	static int alarm_offsets[ 3 ];
+	RTC_NXP&				rtc_dev;
+	uint8_t					tick_period;
+	volatile uint8_t		edge_count;
+	volatile unsigned long	edge_us;
+	uint8_t					tick_count;
+	bool					sync;
+	unsigned long			prev_us;
+	uint32_t				rtc_sec;
+	uint32_t				n_ticks;
+	uint16_t				n_missed;
+	callback_t				cb_func;
+	uint16_t				cb_interval;
+	uint16_t				cb_phase;
+
+	uint32_t				n_jitter;
+	long					j_min;
+	long					j_max;
+	float					j_sq_sum;
+	uint32_t				n_latency;
+	unsigned long			l_max;
+	float					l_sum;
 };
 
-class ForFutureExtention : public RTC_NXP, public I2C_device
+/** RTC_calibrator class
+ *	
+ *	MCU clock error measurement using RTC clock output (CLKOUT).
+ *	CLKOUT edges are timestamped by micros() in ISR and compared with the RTC frequency. 
+ *	Measured error is used to correct millis() based timing.
+ *	Use 1 Hz or 1024 Hz CLKOUT. 32768 Hz is too fast for interrupt handling on most MCUs
+ *
+ *  @class RTC_calibrator
+ */
+
+class RTC_calibrator
+{
+public:
+	/** Create a RTC_calibrator instance
+	 *
+	 * @param freq CLKOUT frequency in Hz (default: 1)
+	 * @param window number of edge intervals for a measurement (default: 10)
+	 */
+	RTC_calibrator( uint16_t freq = 1, uint16_t window = 10 );
+
+	/** Destructor */
+	virtual ~RTC_calibrator();
+
+	/** Start measurement
+	 *	Measurement result is kept. Only current measurement is restarted
+	 */
+	void begin( void );
+
+	/** CLKOUT edge notification. Call this from ISR
+	 */
+	void edge( void );
+
+	/** Measurement update. Call this from loop()
+	 *
+	 *	Measurement restarts from last edge automatically to track changes of the error
+	 *
+	 * @return true, if new result is available
+	 */
+	bool update( void );
+
+	/** MCU clock error
+	 *
+	 * @return error in ppm. Positive if the MCU clock is faster than RTC
+	 */
+	float ppm( void );
+
+	/** Number of measurement results after instance creation
+	 *
+	 * @return count of results
+	 */
+	uint16_t count( void );
+
+	/** Conversion from MCU time to RTC time
+	 *
+	 * @param mcu_ms duration measured by millis()
+	 * @return corrected duration
+	 */
+	unsigned long rtc_ms( unsigned long mcu_ms );
+
+	/** Conversion from RTC time to MCU time
+	 *
+	 *	Use this to schedule by millis() with corrected duration
+	 *
+	 * @param ms duration
+	 * @return duration in millis() count
+	 */
+	unsigned long mcu_ms( unsigned long ms );
+
+private:
+	uint16_t				frequency;
+	uint16_t				n_window;
+	volatile uint16_t		n_edges;
+	volatile unsigned long	first_us;
+	volatile unsigned long	last_us;
+	float					error_ppm;
+	uint16_t				n_results;
+};
+
+/** RTC_event_capture class
+ *	
+ *	Timestamping events at interrupt edge without bus access in ISR. 
+ *	capture() in ISR records micros() and cached RTC second into a ring buffer given by user. 
+ *	loop() takes the events by read() with RTC time in microsecond resolution. 
+ *
+ *	The cached RTC second is a reference pair of RTC time and micros() at a second edge. 
+ *	It can be given by sync( RTC_timebase& ) after RTC_timebase::update() or by reference() from 1 Hz ISR. 
+ *	sync( RTC_NXP& ) reads the RTC but sub-second phase is not known, so it gives an accuracy of 1 second only. 
+ *
+ *	The ring buffer is lock-free for single producer (ISR) and single consumer (loop). 
+ *
+ *  @class RTC_event_capture
+ */
+
+class RTC_event_capture
+{
+public:
+	/** Captured event */
+	struct event {
+		unsigned long	us;		//	micros() at the edge
+		uint32_t		sec;	//	RTC time at the edge (seconds since 2000-01-01 00:00:00)
+		long			usec;	//	microseconds in the second
+		uint8_t			source;	//	ID given to capture()
+	};
+
+	/** Create a RTC_event_capture instance
+	 *
+	 * @param buffer event buffer
+	 * @param size number of events in the buffer (up to 255). One entry is kept unused to tell full from empty
+	 */
+	RTC_event_capture( event *buffer, uint8_t size );
+
+	/** Destructor */
+	virtual ~RTC_event_capture();
+
+	/** Capture an event. Call this from ISR
+	 *
+	 * @param source ID to identify the event source
+	 * @return false if the buffer is full
+	 */
+	bool capture( uint8_t source = 0 );
+
+	/** Set reference. Call this from ISR or with interrupts disabled
+	 *
+	 * @param sec RTC time at the second edge (seconds since 2000-01-01 00:00:00)
+	 * @param edge_us micros() at the second edge
+	 */
+	void reference( uint32_t sec, unsigned long edge_us );
+
+	/** Set reference from RTC_timebase. Call this after RTC_timebase::update() returned true
+	 *
+	 * @param timebase RTC_timebase instance
+	 */
+	void sync( RTC_timebase& timebase );
+
+	/** Set reference from RTC (1 second accuracy)
+	 *
+	 * @param rtc RTC instance
+	 */
+	void sync( RTC_NXP& rtc );
+
+	/** Take an event. Call this from loop()
+	 *
+	 * @param e event to be filled
+	 * @return false if no event
+	 */
+	bool read( event& e );
+
+	/** Number of events in the buffer */
+	uint8_t available( void );
+
+	/** Number of events dropped by buffer full */
+	uint16_t overflows( void );
+
+private:
+	event					*buf;
+	uint8_t					buf_size;
+	volatile uint8_t		head;
+	volatile uint8_t		tail;
+	volatile uint16_t		n_overflow;
+	volatile uint32_t		ref_sec;
+	volatile unsigned long	ref_us;
+};
+
+/** RTC_monotonic class
+ *	
+ *	Monotonic clock service. RTC time is interpolated by micros() and read without bus access. 
+ *	Time is in microseconds since 2000-01-01 00:00:00 and never goes backwards. 
+ *
+ *	At sync(), difference between RTC time and the clock is not stepped but slewed: 
+ *	the clock runs faster or slower by the slew rate until the difference is absorbed. 
+ *	MCU clock error is estimated from the differences at syncs and compensated. 
+ *
+ *	sync() reads the RTC. On PCF2131 and PCF85263A, 100th-seconds register gives 10 ms resolution. 
+ *	On other devices the phase in the second is not known, so use sync( RTC_timebase& ) 
+ *	or sync( sec, edge_us ) with 1 Hz interrupt to get the second edge. 
+ *
+ *	Call now_us() or sync() at least every 70 minutes to follow micros() wrap-around. 
+ *	Slewing a large difference takes long time (1 second takes 2000 seconds at 500 ppm), 
+ *	so call begin() after setting the RTC if a step of the clock is acceptable. 
+ *
+ *  @class RTC_monotonic
+ */
+
+class RTC_monotonic
+{
+public:
+	/** Create a RTC_monotonic instance
+	 *
+	 * @param rtc RTC instance
+	 * @param slew_ppm maximum slew rate in ppm (default: 500)
+	 */
+	RTC_monotonic( RTC_NXP& rtc, uint16_t slew_ppm = 500 );
+
+	/** Destructor */
+	virtual ~RTC_monotonic();
+
+	/** Start the clock. The clock is set to RTC time (this is the only step)
+	 */
+	void begin( void );
+
+	/** Sync to RTC by reading time registers
+	 *
+	 * @return difference of RTC time from the clock in microseconds (positive if the clock is behind)
+	 */
+	long sync( void );
+
+	/** Sync to the second edge of RTC_timebase. Call this after RTC_timebase::update() returned true
+	 *
+	 * @param timebase RTC_timebase instance
+	 * @return difference of RTC time from the clock in microseconds (positive if the clock is behind)
+	 */
+	long sync( RTC_timebase& timebase );
+
+	/** Sync to a second edge
+	 *
+	 * @param sec RTC time at the second edge (seconds since 2000-01-01 00:00:00)
+	 * @param edge_us micros() at the second edge
+	 * @return difference of RTC time from the clock in microseconds (positive if the clock is behind)
+	 */
+	long sync( uint32_t sec, unsigned long edge_us );
+
+	/** Current time without bus access
+	 *
+	 * @return microseconds since 2000-01-01 00:00:00
+	 */
+	uint64_t now_us( void );
+
+	/** Current time without bus access
+	 *
+	 * @return seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( void );
+
+	/** Difference not yet absorbed by slewing
+	 *
+	 * @return microseconds (positive if the clock is behind RTC)
+	 */
+	long pending( void );
+
+	/** Estimated MCU clock error
+	 *
+	 * @return error in ppm (positive if micros() runs fast)
+	 */
+	float ppm( void );
+
+private:
+	void	read_rtc( uint64_t* ref, unsigned long* ref_us );
+	void	advance( void );
+	long	correct( uint64_t ref, unsigned long ref_us );
+
+	RTC_NXP&		rtc_dev;
+	uint16_t		slew;
+	unsigned long	base_us;
+	uint64_t		mono;
+	float			frac;
+	float			pend;
+	float			rate;
+	uint64_t		last_at;
+	uint64_t		prev_at;
+	float			drift_err;
+	uint16_t		fll_window;
+};
+
+/** RTC_wakeup class
+ *	
+ *	Waits until an RTC instant with 10 ms resolution, without polling the RTC for the coarse part. 
+ *	The alarm is set to the target second and the MCU waits for its interrupt edge calling an idle function 
+ *	(e.g. to put the MCU in sleep). Then the sub-second part is finished: 
+ *	on PCF2131 and PCF85263A by tracking 100th-seconds register, on other devices by micros() from the edge. 
+ *
+ *	Alarm setting of the RTC is used and disabled after the wait: an alarm set by user is overwritten. 
+ *	All interrupt flags are cleared by int_clear() before and after the wait, 
+ *	and also when an interrupt comes before the target time. 
+ *	The alarm interrupt must be routed to an MCU pin and edge() must be called from its ISR. 
+ *	Idle function must return on any interrupt (sleep modes which stop the ISR are not usable). 
+ *
+ *	Usage:
+ *	  RTC_wakeup	wakeup( rtc );
+ *	  void pin_int_callback() { wakeup.edge(); }
+ *	  ...
+ *	  wakeup.wait_until( t, 50 );	//	wait until t + 0.50 second
+ *
+ *  @class RTC_wakeup
+ */
+
+class RTC_wakeup
+{
+public:
+	/** Idle function type. Called repeatedly while waiting the alarm */
+	typedef void (*idle_t)( void );
+
+	/** Create a RTC_wakeup instance
+	 *
+	 * @param rtc RTC instance
+	 * @param idle idle function (default: none, the MCU spins without bus access)
+	 */
+	RTC_wakeup( RTC_NXP& rtc, idle_t idle = NULL );
+
+	/** Destructor */
+	virtual ~RTC_wakeup();
+
+	/** Interrupt edge notification. Call this from ISR */
+	void edge( void );
+
+	/** Idle function setting
+	 *
+	 * @param func idle function. NULL for no idle function
+	 */
+	void idle( idle_t func );
+
+	/** Wait until RTC time
+	 *
+	 * @param t RTC time in time_t (same as time() returns)
+	 * @param centiseconds 100th-seconds in the second (0 .. 99)
+	 * @return true if returned at the time. false if the time has passed already or alarm interrupt is not detected
+	 *
+	 * @note Alarm is disabled and interrupt flags are cleared by this method
+	 */
+	bool wait_until( time_t t, uint8_t centiseconds = 0 );
+
+	/** micros() at the alarm edge of last wait
+	 *
+	 * @return micros() value
+	 */
+	unsigned long edge_micros( void );
+
+private:
+	bool	wait_edge( uint8_t count, uint32_t target, uint32_t timeout_s );
+
+	RTC_NXP&				rtc_dev;
+	idle_t					idle_func;
+	volatile uint8_t		edge_count;
+	volatile unsigned long	edge_us;
+};
+
+/** RTC_group class
+ *	
+ *	Sets time of several RTCs to start at same instant. 
+ *	All devices are preloaded with the clock stopped, then released back-to-back by one register write each. 
+ *	Release can be done on an interrupt edge (e.g. PPS or 1 Hz from a reference) to align the group to it. 
+ *	Devices without STOP bit (PCF85053A) are set by set32() after the others are released. 
+ *
+ *	Residual skew is measured by skew_us(): 
+ *	time of a 100th-seconds (or seconds) change is found on each device by register reads, 
+ *	and compared with the first device. Resolution is time of a register read. 
+ *
+ *	Usage:
+ *	  RTC_NXP	*rtcs[]	= { &rtc0, &rtc1 };
+ *	  RTC_group	group( rtcs, 2 );
+ *	  group.set32( t );
+ *	  long	skew	= group.skew_us();
+ *
+ *  @class RTC_group
+ */
+
+class RTC_group
+{
+public:
+	/** Create a RTC_group instance
+	 *
+	 * @param devices array of RTC instance pointers. The array must be kept while the instance is used
+	 * @param n number of devices (up to 32)
+	 */
+	RTC_group( RTC_NXP** devices, uint8_t n );
+
+	/** Destructor */
+	virtual ~RTC_group();
+
+	/** Load time into all devices with the clock stopped
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00, which the clocks start from
+	 * @return true if all devices are stopped (false if a device without STOP bit is included)
+	 */
+	bool preload( uint32_t t );
+
+	/** Start all devices back-to-back
+	 */
+	void release( void );
+
+	/** Interrupt edge notification. Call this from ISR
+	 */
+	void edge( void );
+
+	/** Start all devices at next edge() call
+	 *
+	 * @param timeout_ms maximum time to wait the edge
+	 * @return false if no edge in the time (devices are kept stopped)
+	 */
+	bool release_on_edge( uint32_t timeout_ms = 2000 );
+
+	/** Set time into all devices: preload() and release()
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00
+	 */
+	void set32( uint32_t t );
+
+	/** Time taken to release all devices
+	 *
+	 * @return microseconds from first release write to last one
+	 */
+	unsigned long release_span( void );
+
+	/** Measure residual skew
+	 *
+	 *	It takes 10 ms (100th-seconds register) or 1 second (seconds register) at most for each device 
+	 *
+	 * @return maximum time difference from the first device in microseconds. Negative if a device did not change in 1.1 seconds
+	 */
+	long skew_us( void );
+
+	/** Measure offset of each device from the first device
+	 *
+	 *	Same measurement as skew_us(). Offset is positive if the device is ahead of the first device
+	 *
+	 * @param us array of number of devices to store the offsets in microseconds (us[ 0 ] is 0)
+	 * @param t pointer to store time of the first device (seconds since 2000-01-01 00:00:00). Not stored if NULL
+	 * @return false if a device did not change in 1.1 seconds
+	 */
+	bool offsets( long* us, uint32_t* t = NULL );
+
+	/** Number of devices
+	 *
+	 * @return number of devices
+	 */
+	uint8_t size( void );
+
+private:
+	bool	change( RTC_NXP* d, uint32_t base, long* v, unsigned long* us );
+
+	RTC_NXP**			dev;
+	uint8_t				n_dev;
+	uint32_t			held;
+	uint32_t			load_t;
+	unsigned long		span_us;
+	volatile uint8_t	edge_count;
+};
+
+/** RTC_drift_meter class
+ *	
+ *	Measures offset and drift rate between RTCs in a RTC_group. 
+ *	On each sample(), offsets from the first device are measured at register change timing (see RTC_group::offsets()). 
+ *	Drift rate is a least squares fit of the offsets over time. 
+ *	Samples can be written to a Print stream in CSV or binary. 
+ *
+ *	CSV    : header line "t,dev1_us,dev2_us,...", then "seconds since 2000,offsets in microseconds" on each sample
+ *	Binary : header 'R', 'T', 'C', 'D', version(1), number of devices(1), 
+ *	         then on each sample: time(4), offsets of device 1 .. n-1 (4 each). Little endian, signed offsets
+ *
+ *	Usage:
+ *	  RTC_drift_meter::track	tracks[ 2 ];
+ *	  RTC_drift_meter			meter( group, tracks );
+ *	  meter.output( Serial );
+ *	  meter.sample();	//	call periodically
+ *	  meter.drift_ppm( 1 );
+ *
+ *  @class RTC_drift_meter
+ */
+
+class RTC_drift_meter
+{
+public:
+	/** Output format */
+	enum format {
+		CSV,
+		BINARY,
+	};
+
+	/** Statistics of a device: offset from the first device and its fitting over time */
+	struct track {
+		long	offset;
+		float	mean_t;
+		float	mean_o;
+		float	c_tt;
+		float	c_to;
+	};
+
+	/** Create a RTC_drift_meter instance
+	 *
+	 * @param group devices to be measured
+	 * @param tracks array of the number of devices in the group
+	 */
+	RTC_drift_meter( RTC_group& group, track* tracks );
+
+	/** Destructor */
+	virtual ~RTC_drift_meter();
+
+	/** Output setting. Header is written at this call
+	 *
+	 * @param out output stream for each sample
+	 * @param f format
+	 */
+	void output( Print& out, format f = CSV );
+
+	/** Stop output */
+	void output_stop( void );
+
+	/** Take a sample
+	 *
+	 *	It takes 10 ms (100th-seconds register) or 1 second (seconds register) at most for each device 
+	 *
+	 * @return false if measurement failed
+	 */
+	bool sample( void );
+
+	/** Number of samples
+	 *
+	 * @return count
+	 */
+	uint32_t samples( void );
+
+	/** Offset between devices at last sample
+	 *
+	 * @param i device index
+	 * @param j reference device index
+	 * @return offset of device i from device j in microseconds. Positive if device i is ahead
+	 */
+	long offset_us( uint8_t i, uint8_t j = 0 );
+
+	/** Drift rate between devices
+	 *
+	 * @param i device index
+	 * @param j reference device index
+	 * @return rate of device i relative to device j in ppm. Positive if device i runs faster. 0 with less than 2 samples
+	 */
+	float drift_ppm( uint8_t i, uint8_t j = 0 );
+
+	/** Print offset and drift of all pairs in CSV: "i,j,offset_us,drift_ppm"
+	 *
+	 * @param out output stream
+	 */
+	void report( Print& out );
+
+	/** Clear samples */
+	void reset( void );
+
+private:
+	void	put32( uint32_t v );
+
+	RTC_group&	grp;
+	track		*trk;
+	Print		*out_p;
+	format		fmt;
+	uint32_t	n_samples;
+	uint32_t	t_start;
+};
+
+/** RTC_probe class
+ *	
+ *	Finds an RTC on I2C-bus and creates the driver instance for it. 
+ *	Default addresses of the constructors are checked in order of 0x53 (PCF2131), 0x51 (PCF85063A, PCF85063TP or PCF85263A) and 0x6F (PCF85053A). 
+ *	Chips are told apart by register map with one burst read on each address. 
+ *	On 0x51, registers 0x00 .. 0x13 are read and the chips differ in where the register address wraps to 0x00: 
+ *	  PCF85063TP : after 0x0A: 0x00 .. 0x06 are read again in place of alarm and timer registers 0x0B .. 0x11 of PCF85063A
+ *	  PCF85063A  : after 0x11: 0x00 and 0x01 are read again at 0x12 and 0x13
+ *	  PCF85263A  : after 0x2F: no wrap in the burst (taken if the PCF85063A/TP map does not fit, as 0x12 and 0x13 can match by chance)
+ *	  PCF85053A  : time registers placed with alarm registers in between
+ *	Time registers are checked to be in BCD range for each map, so that other devices on the addresses are not taken. 
+ *	No register is written. PCF2131 on SPI cannot be probed. 
+ *
+ *	Usage:
+ *	  RTC_probe	probe;
+ *	  RTC_NXP	*rtc	= probe.create();
+ *	  if ( rtc )
+ *	    rtc->time( NULL );
+ *
+ *  @class RTC_probe
+ */
+
+class RTC_probe
+{
+public:
+	/** Chip types */
+	enum chip_type {
+		CHIP_NONE,
+		CHIP_PCF2131,
+		CHIP_PCF85063A,
+		CHIP_PCF85063TP,
+		CHIP_PCF85263A,
+		CHIP_PCF85053A,
+	};
+
+	/** Create a RTC_probe instance on Wire */
+	RTC_probe();
+
+	/** Create a RTC_probe instance on specified I2C pins
+	 *
+	 * @param wire TwoWire instance
+	 */
+	RTC_probe( TwoWire& wire );
+
+	/** Destructor */
+	virtual ~RTC_probe();
+
+	/** Find a chip
+	 *
+	 * @return chip type. CHIP_NONE if not found
+	 */
+	chip_type detect( void );
+
+	/** Find a chip and create its driver instance
+	 *
+	 *	The instance is allocated by new and begin() is done. It can be deleted by user when it is not needed
+	 *
+	 * @return pointer to the instance. NULL if no chip found
+	 */
+	RTC_NXP* create( void );
+
+	/** Chip found by last detect() or create()
+	 *
+	 * @return chip type
+	 */
+	chip_type type( void );
+
+	/** Address of the chip found by last detect() or create()
+	 *
+	 * @return 7 bit I2C address. 0 if no chip found
+	 */
+	uint8_t address( void );
+
+	/** Name of the chip found by last detect() or create()
+	 *
+	 * @return name string like "PCF85063A". "none" if no chip found
+	 */
+	const char* name( void );
+
+private:
+	chip_type	check( uint8_t addr );
+
+	TwoWire&	bus;
+	chip_type	found;
+	uint8_t		found_addr;
+};
+
+#if RTC_NXP_CHRONO
+/** rtc_nxp_clock class
+ *	
+ *	std::chrono clock backed by RTC. Meets the Clock requirements (now(), duration, time_point). 
+ *	now() is served from RTC_monotonic without bus access. The RTC is read to sync only when 
+ *	the sync interval has passed since last sync, so the clock can be called in hot paths. 
+ *	Epoch is 2000-01-01 00:00:00. to_time_t()/from_time_t() convert from/to time_t in same way as RTC_NXP::time(). 
+ *
+ *	Usage:
+ *	  RTC_monotonic	mono( rtc );
+ *	  mono.begin();
+ *	  rtc_nxp_clock::source( mono );
+ *	  rtc_nxp_clock::time_point	t	= rtc_nxp_clock::now();
+ *
+ *  @class rtc_nxp_clock
+ */
+
+class rtc_nxp_clock
+{
+public:
+	typedef std::chrono::microseconds				duration;
+	typedef duration::rep							rep;
+	typedef duration::period						period;
+	typedef std::chrono::time_point<rtc_nxp_clock>	time_point;
+
+	/** Never goes backwards (corrections are slewed by RTC_monotonic) */
+	static const bool	is_steady	= true;
+
+	/** Set source clock
+	 *
+	 * @param mono RTC_monotonic instance. begin() must be done before now() is called
+	 * @param sync_interval_s interval of sync() with RTC reading, in seconds (default: 10). 0 for no automatic sync
+	 */
+	static void source( RTC_monotonic& mono, uint16_t sync_interval_s = 10 );
+
+	/** Current time
+	 *
+	 *	Not noexcept: taking the lock (RTC_NXP_MULTITHREAD) and RTC reading for sync can throw
+	 *
+	 * @return time_point since 2000-01-01 00:00:00. Epoch if no source is set
+	 */
+	static time_point now( void );
+
+	/** Number of RTC reads done in now()
+	 *
+	 * @return count
+	 */
+	static uint32_t syncs( void );
+
+	/** time_point to UNIX time conversion (by RTC_NXP::time_2000(), same as RTC_NXP::time()) */
+	static time_t to_time_t( const time_point& t ) noexcept;
+
+	/** UNIX time to time_point conversion (by RTC_NXP::time_2000(), same as RTC_NXP::time()) */
+	static time_point from_time_t( time_t t ) noexcept;
+
+private:
+	static RTC_monotonic	*mono_p;
+	static uint64_t			interval_us;
+	static uint64_t			next_sync;
+	static uint32_t			n_syncs;
+};
+#endif	//	RTC_NXP_CHRONO
+
+class ForFutureExtention : public RTC_NXP, public I2C_for_RTC
 {
 public:
 	/** Constructor */
@@ -1565,10 +4180,23 @@ public:
 	 */
 	void alarm_disable( void );
 
+	/** Alarm setting for all digits at once
+	 *
+	 * @param mask digits to be matched. Compose value by ORing MATCH_SECOND, MATCH_MINUTE, MATCH_HOUR, MATCH_DAY and MATCH_WEEKDAY
+	 * @param alarm_tm struct to specify alarm time
+	 */
+	void alarm_match( uint8_t mask, struct tm* alarm_tm );
+
 	/** Interrupt clear
 	 */
 	uint8_t int_clear( void );
 
+	/** Set clock output (CLKOUT)
+	 *
+	 * @param freq choose desired clock output (CLKOUT) frequency in 'enum clock_out_frequency'
+	 */
+	void set_clock_out( clock_out_frequency freq );
+
 	
 #if DOXYGEN_ONLY
 	/** time
@@ -1579,6 +4207,87 @@ public:
 	 * @return time_t value of current time
 	 */
 	time_t time( time_t* tp );
+
+	/** now32
+	 *
+	 *	Current time in seconds since 2000-01-01 00:00:00.
+	 *	Converted straight from BCD registers without using "struct tm"
+	 *
+	 * @return uint32_t seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( void );
+
+	/** now32 with 100th-seconds
+	 *
+	 * @param hundredths pointer to store 100th-seconds (0 on devices which don't have 100th-seconds register)
+	 * @return uint32_t seconds since 2000-01-01 00:00:00
+	 */
+	uint32_t now32( uint8_t* hundredths );
+
+	/** 100th-seconds register availability
+	 *
+	 * @return true if the device has 100th-seconds register
+	 */
+	bool has_hundredths( void );
+
+	/** set32
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00 to set calendar and time in RTC
+	 */
+	void set32( uint32_t t );
+
+	/** Load time with the clock stopped
+	 *
+	 *	Time registers are written with STOP bit set and the prescaler cleared. 
+	 *	The clock starts from this time by release(). Used to start RTCs at same instant (see RTC_group)
+	 *
+	 * @param t seconds since 2000-01-01 00:00:00
+	 * @return false if the device has no STOP bit (nothing done)
+	 */
+	bool preload( uint32_t t );
+
+	/** Start the clock stopped by preload(). Done by one register write
+	 */
+	void release( void );
+
+	/** Configuration snapshot
+	 *
+	 *	Configuration registers are read in a few bursts (each fits in the I2C buffer) into a blob of chip tag, data size and register data. 
+	 *	Time registers are not included
+	 *
+	 * @param blob pointer to buffer of SNAPSHOT_SIZE bytes
+	 * @return blob size. 0 if the device is not supported
+	 */
+	uint8_t snapshot( uint8_t* blob );
+
+	/** Restore configuration from snapshot
+	 *
+	 *	Registers are written in a few bursts (each fits in the I2C buffer). 
+	 *	Time registers, STOP bit and reset commands are not written. Interrupt flags are kept as those are
+	 *
+	 * @param blob pointer to blob made by snapshot() on same type of device
+	 * @return false if the blob is not for this type of device
+	 */
+	bool restore( const uint8_t* blob );
+
+	/** ISO 8601 time string
+	 *
+	 *	Writes "YYYY-MM-DDThh:mm:ss" or "YYYY-MM-DDThh:mm:ss.cc" into given buffer.
+	 *	BCD registers are converted into characters directly without binary conversion
+	 *
+	 * @param s pointer to char buffer. 20 bytes needed, 23 bytes with hundredths
+	 * @param hundredths appending ".cc" if true. It will be ".00" on devices which don't have 100th-seconds register
+	 * @return pointer to the string
+	 */
+	char* iso8601( char* s, bool hundredths = false );
+
+	/** Alarm setting by time_t
+	 * 
+	 *	Sets alarm matching to second, minute, hour and day of given time
+	 *
+	 * @param t alarm time
+	 */
+	void alarm_at( time_t t );
 	
 	/** Multiple register write
 	 * 
@@ -1642,6 +4351,18 @@ protected:
 	 * @return time_t returns RTC time in time_t format
 	 */
 	time_t rtc_time( void );
+
+	/** Read time registers
+	 *
+	 * @param bf pointer to 8 bytes buffer for time register image
+	 */
+	void rtc_time_regs( uint8_t* bf );
+
+	/** Write time registers
+	 *
+	 * @param bf pointer to 8 bytes time register image
+	 */
+	void set_time_regs( uint8_t* bf );
 };
 
 
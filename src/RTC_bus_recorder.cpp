@@ -0,0 +1,118 @@
+#include "RTC_NXP.h"
+
+RTC_bus_recorder	*RTC_bus_recorder::active	= NULL;
+
+RTC_bus_recorder::RTC_bus_recorder( Print& out ) : out_stream( out ), last_us( 0 ), count( 0 )
+{
+}
+
+RTC_bus_recorder::~RTC_bus_recorder()
+{
+	stop();
+}
+
+void RTC_bus_recorder::start( void )
+{
+	const uint8_t	header[]	= { 'R', 'T', 'C', 'T', version };
+
+	noInterrupts();
+	active	= NULL;
+	interrupts();
+
+	put( header, sizeof( header ) );
+	last_us	= micros();
+	count	= 0;
+
+	active	= this;
+}
+
+void RTC_bus_recorder::stop( void )
+{
+	noInterrupts();
+	if ( active == this )
+		active	= NULL;
+	interrupts();
+}
+
+void RTC_bus_recorder::marker( uint8_t id )
+{
+	if ( active != this )
+		return;
+
+	record_head( MARKER );
+	put( &id, 1 );
+}
+
+unsigned long RTC_bus_recorder::records( void )
+{
+	return count;
+}
+
+//	"active" is loaded once: it can be cleared by stop() in other context after recording() check
+
+void RTC_bus_recorder::reg_access( uint8_t type, uint8_t dev, uint8_t reg, const uint8_t *data, int size )
+{
+	RTC_bus_recorder	*rec	= active;
+	uint8_t				v[]		= { dev, reg, (uint8_t)size };
+	
+	if ( !rec )
+		return;
+	
+	rec->record_head( type );
+	rec->put( v, sizeof( v ) );
+	rec->put( data, (uint8_t)size );
+}
+
+void RTC_bus_recorder::access_error( uint8_t type, uint8_t dev, uint8_t reg, uint8_t status )
+{
+	RTC_bus_recorder	*rec	= active;
+	uint8_t				v[]		= { dev, reg, type, status };
+	
+	if ( !rec )
+		return;
+	
+	rec->record_head( ACCESS_ERROR );
+	rec->put( v, sizeof( v ) );
+}
+
+void RTC_bus_recorder::transfer( const uint8_t *tx, const uint8_t *rx, int size )
+{
+	RTC_bus_recorder	*rec	= active;
+	uint8_t				len		= (uint8_t)size;
+	
+	if ( !rec )
+		return;
+	
+	rec->record_head( SPI_TRANSFER );
+	rec->put( &len, 1 );
+	rec->put( tx, len );
+	rec->put( rx, len );
+}
+
+void RTC_bus_recorder::record_head( uint8_t type )
+{
+	unsigned long	now	= micros();
+	uint32_t		dt	= (uint32_t)(now - last_us);
+	uint8_t			v[ 6 ];
+	int				n	= 0;
+
+	last_us	= now;
+
+	v[ n++ ]	= type;
+
+	do {
+		v[ n ]	= dt & 0x7F;
+		dt	>>= 7;
+		if ( dt )
+			v[ n ]	|= 0x80;
+		n++;
+	} while ( dt );
+
+	put( v, n );
+	count++;
+}
+
+void RTC_bus_recorder::put( const uint8_t *data, int size )
+{
+	out_stream.write( data, size );
+}
@@ -0,0 +1,77 @@
+#include "RTC_NXP.h"
+
+RTC_calibrator::RTC_calibrator( uint16_t freq, uint16_t window ) : 
+	frequency( freq ), n_window( window ), n_edges( 0 ), first_us( 0 ), last_us( 0 ), error_ppm( 0.0 ), n_results( 0 )
+{
+}
+
+RTC_calibrator::~RTC_calibrator()
+{
+}
+
+void RTC_calibrator::begin( void )
+{
+	noInterrupts();
+	n_edges	= 0;
+	interrupts();
+}
+
+void RTC_calibrator::edge( void )
+{
+	unsigned long	now_us	= micros();
+	
+	if ( !n_edges )
+		first_us	= now_us;
+	
+	last_us	= now_us;
+	n_edges++;
+}
+
+bool RTC_calibrator::update( void )
+{
+	uint16_t		n;
+	unsigned long	f_us;
+	unsigned long	l_us;
+	
+	noInterrupts();
+	n		= n_edges;
+	f_us	= first_us;
+	l_us	= last_us;
+	
+	if ( n > n_window ) {
+		n_edges		= 1;	//	restart from last edge
+		first_us	= l_us;
+	}
+	interrupts();
+	
+	if ( n <= n_window )
+		return false;
+
+	float	expected	= (n - 1) * (1e6 / frequency);
+	
+	error_ppm	= ((l_us - f_us) - expected) / expected * 1e6;
+	n_results++;
+	
+	return true;
+}
+
+float RTC_calibrator::ppm( void )
+{
+	return error_ppm;
+}
+
+uint16_t RTC_calibrator::count( void )
+{
+	return n_results;
+}
+
+unsigned long RTC_calibrator::rtc_ms( unsigned long mcu_ms )
+{
+	//	correction part is calculated separately to keep precision on float
+	return mcu_ms - (long)(mcu_ms * (error_ppm / (1e6 + error_ppm)));
+}
+
+unsigned long RTC_calibrator::mcu_ms( unsigned long ms )
+{
+	return ms + (long)(ms * (error_ppm * 1e-6));
+}
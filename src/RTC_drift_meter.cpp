@@ -0,0 +1,152 @@
+#include "RTC_NXP.h"
+
+RTC_drift_meter::RTC_drift_meter( RTC_group& group, track* tracks ) : 
+	grp( group ), trk( tracks ), out_p( NULL ), fmt( CSV ), n_samples( 0 ), t_start( 0 )
+{
+	reset();
+}
+
+RTC_drift_meter::~RTC_drift_meter()
+{
+}
+
+void RTC_drift_meter::output( Print& out, format f )
+{
+	out_p	= &out;
+	fmt		= f;
+
+	if ( BINARY == fmt ) {
+		const uint8_t	header[]	= { 'R', 'T', 'C', 'D', 1, grp.size() };
+		
+		out_p->write( header, sizeof( header ) );
+		return;
+	}
+	
+	out_p->print( "t" );
+	
+	for ( int i = 1; i < grp.size(); i++ ) {
+		out_p->print( ",dev" );
+		out_p->print( i );
+		out_p->print( "_us" );
+	}
+	
+	out_p->println();
+}
+
+void RTC_drift_meter::output_stop( void )
+{
+	out_p	= NULL;
+}
+
+bool RTC_drift_meter::sample( void )
+{
+	uint8_t		n	= grp.size();
+	long		us[ n ];
+	uint32_t	t;
+	
+	if ( !grp.offsets( us, &t ) )
+		return false;
+	
+	if ( !n_samples )
+		t_start	= t;
+	
+	n_samples++;
+
+	//	running mean and co-moment of time and offset: numerically stable in float
+	float	x	= (float)(t - t_start);
+
+	for ( int i = 0; i < n; i++ ) {
+		track&	r	= trk[ i ];
+		float	dx	= x - r.mean_t;
+		
+		r.offset	 = us[ i ];
+		r.mean_t	+= dx / n_samples;
+		r.mean_o	+= (us[ i ] - r.mean_o) / n_samples;
+		r.c_tt		+= dx * (x - r.mean_t);
+		r.c_to		+= dx * (us[ i ] - r.mean_o);
+	}
+
+	if ( !out_p )
+		return true;
+	
+	if ( BINARY == fmt ) {
+		put32( t );
+
+		for ( int i = 1; i < n; i++ )
+			put32( (uint32_t)us[ i ] );
+
+		return true;
+	}
+
+	out_p->print( t );
+	
+	for ( int i = 1; i < n; i++ ) {
+		out_p->print( "," );
+		out_p->print( us[ i ] );
+	}
+	
+	out_p->println();
+
+	return true;
+}
+
+uint32_t RTC_drift_meter::samples( void )
+{
+	return n_samples;
+}
+
+long RTC_drift_meter::offset_us( uint8_t i, uint8_t j )
+{
+	return trk[ i ].offset - trk[ j ].offset;
+}
+
+float RTC_drift_meter::drift_ppm( uint8_t i, uint8_t j )
+{
+	//	microseconds per second is ppm
+	if ( (n_samples < 2) || (trk[ 0 ].c_tt == 0.0) )
+		return 0.0;
+	
+	return (trk[ i ].c_to - trk[ j ].c_to) / trk[ 0 ].c_tt;
+}
+
+void RTC_drift_meter::report( Print& out )
+{
+	out.println( "i,j,offset_us,drift_ppm" );
+
+	for ( int i = 0; i < grp.size(); i++ ) {
+		for ( int j = i + 1; j < grp.size(); j++ ) {
+			out.print( i );
+			out.print( "," );
+			out.print( j );
+			out.print( "," );
+			out.print( offset_us( i, j ) );
+			out.print( "," );
+			out.println( drift_ppm( i, j ), 3 );
+		}
+	}
+}
+
+void RTC_drift_meter::reset( void )
+{
+	n_samples	= 0;
+
+	for ( int i = 0; i < grp.size(); i++ ) {
+		trk[ i ].offset	= 0;
+		trk[ i ].mean_t	= 0.0;
+		trk[ i ].mean_o	= 0.0;
+		trk[ i ].c_tt	= 0.0;
+		trk[ i ].c_to	= 0.0;
+	}
+}
+
+void RTC_drift_meter::put32( uint32_t v )
+{
+	uint8_t	b[ 4 ];
+	
+	for ( int i = 0; i < 4; i++ ) {
+		b[ i ]	= v & 0xFF;
+		v	>>= 8;
+	}
+	
+	out_p->write( b, sizeof( b ) );
+}
@@ -0,0 +1,110 @@
+#include "RTC_NXP.h"
+
+#define	BARRIER()	asm volatile( "" ::: "memory" )
+
+RTC_event_capture::RTC_event_capture( event *buffer, uint8_t size ) :
+	buf( buffer ), buf_size( size ), head( 0 ), tail( 0 ), n_overflow( 0 ), ref_sec( 0 ), ref_us( 0 )
+{
+}
+
+RTC_event_capture::~RTC_event_capture()
+{
+}
+
+bool RTC_event_capture::capture( uint8_t source )
+{
+	unsigned long	now		= micros();
+	uint8_t			h		= head;
+	uint8_t			next	= (h + 1 == buf_size) ? 0 : h + 1;
+	
+	if ( next == tail )
+	{
+		n_overflow++;
+		return false;
+	}
+
+	event&	e	= buf[ h ];
+	
+	e.us		= now;
+	e.sec		= ref_sec;
+	e.usec		= (long)(now - ref_us);	//	normalized in read()
+	e.source	= source;
+	
+	BARRIER();
+	head	= next;
+	
+	return true;
+}
+
+void RTC_event_capture::reference( uint32_t sec, unsigned long edge_us )
+{
+	ref_sec	= sec;
+	ref_us	= edge_us;
+}
+
+void RTC_event_capture::sync( RTC_timebase& timebase )
+{
+	uint32_t		sec	= timebase.now32();
+	unsigned long	us	= timebase.edge_micros();
+
+	noInterrupts();
+	reference( sec, us );
+	interrupts();
+}
+
+void RTC_event_capture::sync( RTC_NXP& rtc )
+{
+	uint32_t		sec	= rtc.now32();
+	unsigned long	us	= micros();
+
+	noInterrupts();
+	reference( sec, us );
+	interrupts();
+}
+
+bool RTC_event_capture::read( event& e )
+{
+	uint8_t	t	= tail;
+
+	if ( t == head )
+		return false;
+
+	BARRIER();
+	e	= buf[ t ];
+	BARRIER();
+	
+	tail	= (t + 1 == buf_size) ? 0 : t + 1;
+
+	long	s	= e.usec / 1000000L;
+	
+	e.usec	-= s * 1000000L;
+	
+	if ( e.usec < 0 )
+	{
+		e.usec	+= 1000000L;
+		s--;
+	}
+
+	e.sec	+= s;
+
+	return true;
+}
+
+uint8_t RTC_event_capture::available( void )
+{
+	uint8_t	h	= head;
+	uint8_t	t	= tail;
+
+	return (h >= t) ? h - t : buf_size - t + h;
+}
+
+uint16_t RTC_event_capture::overflows( void )
+{
+	uint16_t	n;
+
+	noInterrupts();
+	n	= n_overflow;
+	interrupts();
+
+	return n;
+}
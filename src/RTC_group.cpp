@@ -0,0 +1,150 @@
+#include "RTC_NXP.h"
+
+#define	CHANGE_TIMEOUT_US	1100000UL	//	seconds register changes in this time
+
+RTC_group::RTC_group( RTC_NXP** devices, uint8_t n ) : 
+	dev( devices ), n_dev( (n < 32) ? n : 32 ), held( 0 ), load_t( 0 ), span_us( 0 ), edge_count( 0 )
+{
+}
+
+RTC_group::~RTC_group()
+{
+}
+
+bool RTC_group::preload( uint32_t t )
+{
+	load_t	= t;
+	held	= 0;
+	
+	for ( int i = 0; i < n_dev; i++ )
+		if ( dev[ i ]->preload( t ) )
+			held	|= 1UL << i;
+	
+	return held == ((n_dev < 32) ? (1UL << n_dev) - 1 : 0xFFFFFFFFUL);
+}
+
+void RTC_group::release( void )
+{
+	unsigned long	start	= micros();
+	
+	for ( int i = 0; i < n_dev; i++ )
+		if ( held & (1UL << i) )
+			dev[ i ]->release();
+	
+	span_us	= micros() - start;
+
+	//	devices without STOP bit are set now, as close as possible
+	for ( int i = 0; i < n_dev; i++ )
+		if ( !(held & (1UL << i)) )
+			dev[ i ]->set32( load_t );
+
+	held	= 0;
+}
+
+void RTC_group::edge( void )
+{
+	edge_count++;
+}
+
+bool RTC_group::release_on_edge( uint32_t timeout_ms )
+{
+	unsigned long	start	= millis();
+	uint8_t			count;
+
+	noInterrupts();
+	count	= edge_count;
+	interrupts();
+
+	while ( edge_count == count )
+		if ( timeout_ms < (millis() - start) )
+			return false;
+
+	release();
+	return true;
+}
+
+void RTC_group::set32( uint32_t t )
+{
+	preload( t );
+	release();
+}
+
+unsigned long RTC_group::release_span( void )
+{
+	return span_us;
+}
+
+long RTC_group::skew_us( void )
+{
+	long	us[ n_dev ];
+	long	skew_max	= 0;
+
+	if ( !offsets( us ) )
+		return -1;
+
+	for ( int i = 1; i < n_dev; i++ ) {
+		long	skew	= (us[ i ] < 0) ? -us[ i ] : us[ i ];
+		
+		skew_max	= (skew_max < skew) ? skew : skew_max;
+	}
+	
+	return skew_max;
+}
+
+bool RTC_group::offsets( long* us, uint32_t* t )
+{
+	uint32_t		base	= dev[ 0 ]->now32() - 1;
+	long			v0;
+	unsigned long	us0;
+	long			v;
+	unsigned long	at;
+
+	if ( !change( dev[ 0 ], base, &v0, &us0 ) )
+		return false;
+
+	us[ 0 ]	= 0;
+	
+	for ( int i = 1; i < n_dev; i++ ) {
+		if ( !change( dev[ i ], base, &v, &at ) )
+			return false;
+
+		//	v is in 10 ms unit. Device i changed to v at "at". Device 0 shows v at us0 + (v - v0) * 10 ms
+		us[ i ]	= (long)(us0 - at) + (v - v0) * 10000L;
+	}
+	
+	if ( t )
+		*t	= base + v0 / 100;
+
+	return true;
+}
+
+uint8_t RTC_group::size( void )
+{
+	return n_dev;
+}
+
+bool RTC_group::change( RTC_NXP* d, uint32_t base, long* v, unsigned long* us )
+{
+	unsigned long	start	= micros();
+	unsigned long	prev	= start;
+	unsigned long	now;
+	uint8_t			h;
+	uint32_t		t		= d->now32( &h );
+	long			first	= (long)(int32_t)(t - base) * 100 + h;
+	
+	do {
+		now	= micros();
+		t	= d->now32( &h );
+		*v	= (long)(int32_t)(t - base) * 100 + h;
+		
+		if ( *v != first ) {
+			//	changed between previous read and this read
+			*us	= prev + (now - prev) / 2;
+			return true;
+		}
+		
+		prev	= now;
+	} while ( (now - start) < CHANGE_TIMEOUT_US );
+	
+	return false;
+}
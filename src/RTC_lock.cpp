@@ -0,0 +1,82 @@
+#include "RTC_NXP.h"
+
+#if RTC_NXP_MULTITHREAD
+
+RTC_lock::RTC_lock() : depth( 0 )
+{
+	reset_statistics();
+}
+
+RTC_lock::~RTC_lock()
+{
+}
+
+void RTC_lock::acquire( void )
+{
+	unsigned long	wait_start	= micros();
+
+	lock();
+
+	if ( depth++ )
+		return;
+
+	start_us	= micros();
+
+	unsigned long	wait	= start_us - wait_start;
+
+	w_max	= (w_max < wait) ? wait : w_max;
+}
+
+void RTC_lock::release( void )
+{
+	if ( !--depth )
+	{
+		unsigned long	hold	= micros() - start_us;
+
+		h_max	 = (h_max < hold) ? hold : h_max;
+		h_sum	+= hold;
+		n_count++;
+	}
+
+	unlock();
+}
+
+unsigned long RTC_lock::count( void )
+{
+	return n_count;
+}
+
+unsigned long RTC_lock::hold_max( void )
+{
+	return h_max;
+}
+
+float RTC_lock::hold_mean( void )
+{
+	return n_count ? h_sum / n_count : 0.0;
+}
+
+unsigned long RTC_lock::wait_max( void )
+{
+	return w_max;
+}
+
+void RTC_lock::reset_statistics( void )
+{
+	n_count	= 0;
+	h_max	= 0;
+	h_sum	= 0.0;
+	w_max	= 0;
+}
+
+void RTC_std_lock::lock( void )
+{
+	mtx.lock();
+}
+
+void RTC_std_lock::unlock( void )
+{
+	mtx.unlock();
+}
+
+#endif	//	RTC_NXP_MULTITHREAD
@@ -0,0 +1,169 @@
+#include "RTC_NXP.h"
+#include <limits.h>
+#include <math.h>
+
+#define	USEC_PER_SEC		1000000UL
+#define	RATE_LIMIT_PPM		20000.0f	//	MCU clock error over this is taken as time setting
+#define	FLL_MIN_INTERVAL	10			//	seconds
+#define	FLL_MAX_INTERVAL	320			//	seconds
+#define	FLL_GAIN			0.5f
+
+static long to_long( float v )
+{
+	if ( v <= (float)LONG_MIN )
+		return LONG_MIN;
+	if ( (float)LONG_MAX <= v )
+		return LONG_MAX;
+
+	return (long)v;
+}
+
+RTC_monotonic::RTC_monotonic( RTC_NXP& rtc, uint16_t slew_ppm ) :
+	rtc_dev( rtc ), slew( slew_ppm ), base_us( 0 ), mono( 0 ), frac( 0 ), pend( 0 ), rate( 0 ), last_at( 0 ), prev_at( 0 ), drift_err( 0 ), fll_window( FLL_MIN_INTERVAL )
+{
+}
+
+RTC_monotonic::~RTC_monotonic()
+{
+}
+
+void RTC_monotonic::begin( void )
+{
+	read_rtc( &mono, &base_us );
+
+	frac		= 0;
+	pend		= 0;
+	rate		= 0;
+	last_at		= mono;
+	prev_at		= mono;
+	drift_err	= 0;
+	fll_window	= FLL_MIN_INTERVAL;
+}
+
+void RTC_monotonic::read_rtc( uint64_t* ref, unsigned long* ref_us )
+{
+	uint8_t			cs;
+	unsigned long	t0	= micros();
+	uint32_t		sec	= rtc_dev.now32( &cs );
+	unsigned long	t1	= micros();
+
+	//	time registers are taken in middle of the access. 
+	//	Without 100th-seconds, middle of the second is the best guess
+	
+	*ref	= (uint64_t)sec * USEC_PER_SEC + (rtc_dev.has_hundredths() ? cs * 10000UL + 5000 : USEC_PER_SEC / 2);
+	*ref_us	= t0 + (t1 - t0) / 2;
+}
+
+long RTC_monotonic::sync( void )
+{
+	uint64_t		ref;
+	unsigned long	ref_us;
+
+	read_rtc( &ref, &ref_us );
+	return correct( ref, ref_us );
+}
+
+long RTC_monotonic::sync( RTC_timebase& timebase )
+{
+	return sync( timebase.now32(), timebase.edge_micros() );
+}
+
+long RTC_monotonic::sync( uint32_t sec, unsigned long edge_us )
+{
+	return correct( (uint64_t)sec * USEC_PER_SEC, edge_us );
+}
+
+void RTC_monotonic::advance( void )
+{
+	unsigned long	now	= micros();
+	uint32_t		dt	= (uint32_t)(now - base_us);
+	float			r	= dt * 1e-6f;
+	float			a	= r * slew;		//	slew amount in this period
+	float			c;
+	long			ic;
+
+	base_us	= now;
+
+	if ( a > (pend < 0 ? -pend : pend) )
+		a	= (pend < 0 ? -pend : pend);
+
+	if ( pend < 0 )
+		a	= -a;
+
+	pend	-= a;
+
+	//	fraction of microsecond is carried to next call. 
+	//	Adjustment is smaller than dt, so the clock never goes backwards
+	
+	c		= frac + a - r * rate;
+	ic		= (long)c;
+	
+	if ( c < ic )
+		ic--;
+	
+	frac	= c - ic;
+	mono	+= (int64_t)dt + ic;
+}
+
+long RTC_monotonic::correct( uint64_t ref, unsigned long ref_us )
+{
+	advance();
+
+	uint64_t	at		= mono - (int32_t)(uint32_t)(base_us - ref_us);	//	clock value at ref_us
+	float		err		= (float)(int64_t)(ref - at);
+	float		resid	= err - pend;	//	error not explained by pending correction
+	float		since	= (int64_t)(at - prev_at) * 1e-6f;
+
+	//	residual is accumulated as drift of MCU clock unless it is too large (RTC time setting)
+	
+	if ( (0 < since) && (fabs( resid ) <= since * RATE_LIMIT_PPM) )
+		drift_err	+= resid;
+
+	prev_at	= at;
+
+	//	MCU clock error estimation in windows which are doubled up to FLL_MAX_INTERVAL. 
+	//	Intervals are measured by the clock itself, so RTC time setting doesn't affect
+	
+	float	interval	= (int64_t)(at - last_at) * 1e-6f;
+
+	if ( fll_window <= interval )
+	{
+		rate	-= drift_err / interval * ((FLL_MIN_INTERVAL == fll_window) ? 1.0f : FLL_GAIN);
+
+		if ( rate < -RATE_LIMIT_PPM )
+			rate	= -RATE_LIMIT_PPM;
+		else if ( RATE_LIMIT_PPM < rate )
+			rate	= RATE_LIMIT_PPM;
+
+		if ( fll_window < FLL_MAX_INTERVAL )
+			fll_window	*= 2;
+
+		last_at		= at;
+		drift_err	= 0;
+	}
+	
+	pend	= err;
+
+	return to_long( err );
+}
+
+uint64_t RTC_monotonic::now_us( void )
+{
+	advance();
+	return mono;
+}
+
+uint32_t RTC_monotonic::now32( void )
+{
+	return (uint32_t)(now_us() / USEC_PER_SEC);
+}
+
+long RTC_monotonic::pending( void )
+{
+	return to_long( pend );
+}
+
+float RTC_monotonic::ppm( void )
+{
+	return rate;
+}
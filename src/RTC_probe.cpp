@@ -0,0 +1,149 @@
+#include "RTC_NXP.h"
+
+//	no retry: NACK on an empty address is expected
+
+static const I2C_for_RTC::retry_policy	probe_policy	= { 0, 0, 5000 };
+
+static bool bcd_in( uint8_t v, uint8_t lo, uint8_t hi )
+{
+	if ( ((v & 0x0F) > 9) || ((v >> 4) > 9) )
+		return false;
+
+	v	= (v >> 4) * 10 + (v & 0x0F);
+
+	return (lo <= v) && (v <= hi);
+}
+
+//	seconds, minutes, days, weekdays, months and years. Hours is not checked as 12/24 hour mode changes its format
+
+static bool time_regs_valid( uint8_t sec, uint8_t min, uint8_t day, uint8_t wday, uint8_t mon, uint8_t year )
+{
+	return bcd_in( sec & 0x7F, 0, 59 )
+			&& bcd_in( min & 0x7F, 0, 59 )
+			&& bcd_in( day & 0x3F, 1, 31 )
+			&& bcd_in( wday & 0x07, 0, 6 )
+			&& bcd_in( mon & 0x1F, 1, 12 )
+			&& bcd_in( year, 0, 99 );
+}
+
+RTC_probe::RTC_probe() : bus( Wire ), found( CHIP_NONE ), found_addr( 0 )
+{
+}
+
+RTC_probe::RTC_probe( TwoWire& wire ) : bus( wire ), found( CHIP_NONE ), found_addr( 0 )
+{
+}
+
+RTC_probe::~RTC_probe()
+{
+}
+
+RTC_probe::chip_type RTC_probe::detect( void )
+{
+	const uint8_t	addrs[]	= { 0xA6 >> 1, 0xA2 >> 1, 0xDE >> 1 };
+
+	for ( unsigned int i = 0; i < sizeof( addrs ); i++ ) {
+		found	= check( addrs[ i ] );
+
+		if ( CHIP_NONE != found ) {
+			found_addr	= addrs[ i ];
+			return found;
+		}
+	}
+
+	found_addr	= 0;
+	return CHIP_NONE;
+}
+
+RTC_NXP* RTC_probe::create( void )
+{
+	RTC_NXP*	rtc;
+
+	switch ( detect() ) {
+		case CHIP_PCF2131:		rtc	= new PCF2131_I2C( bus, found_addr );	break;
+		case CHIP_PCF85063A:	rtc	= new PCF85063A( bus, found_addr );		break;
+		case CHIP_PCF85063TP:	rtc	= new PCF85063TP( bus, found_addr );	break;
+		case CHIP_PCF85263A:	rtc	= new PCF85263A( bus, found_addr );		break;
+		case CHIP_PCF85053A:	rtc	= new PCF85053A( bus, found_addr );		break;
+		default:
+			return NULL;
+	}
+
+	rtc->begin();
+
+	return rtc;
+}
+
+RTC_probe::chip_type RTC_probe::type( void )
+{
+	return found;
+}
+
+uint8_t RTC_probe::address( void )
+{
+	return found_addr;
+}
+
+const char* RTC_probe::name( void )
+{
+	static const char*	names[]	= { "none", "PCF2131", "PCF85063A", "PCF85063TP", "PCF85263A", "PCF85053A" };
+
+	return names[ found ];
+}
+
+RTC_probe::chip_type RTC_probe::check( uint8_t addr )
+{
+	I2C_for_RTC	dev( bus, addr );
+	uint8_t		r[ 20 ];
+
+	dev.retry( probe_policy );
+
+	switch ( addr ) {
+		case (0xA6 >> 1):
+			//	PCF2131: _100th_Seconds .. Years
+			if ( dev.try_reg_r( 0x06, r, 8 ) )
+				return CHIP_NONE;
+
+			if ( bcd_in( r[ 0 ], 0, 99 ) && time_regs_valid( r[ 1 ], r[ 2 ], r[ 4 ], r[ 5 ], r[ 6 ], r[ 7 ] ) )
+				return CHIP_PCF2131;
+
+			break;
+
+		case (0xA2 >> 1):
+			//	registers 0x00 .. 0x13 in one burst. Chips are told apart by where the register address wraps to 0x00: 
+			//	  PCF85063TP : after Years (0x0A), Control_1 .. Hours are read again at 0x0B .. 0x11
+			//	  PCF85063A  : after Timer_mode (0x11), Control_1 and Control_2 are read again at 0x12 and 0x13
+			//	  PCF85263A  : after 0x2F, so no wrap in this burst
+			//	100th-seconds of PCF85263A is not used: it stays 0 unless 100TH in Function register is set
+			if ( dev.try_reg_r( 0x00, r, sizeof( r ) ) )
+				return CHIP_NONE;
+
+			bool	tp, a;
+
+			tp	= !memcmp( r + 11, r, 7 );
+			a	= !memcmp( r + 18, r, 2 );
+
+			//	PCF85063A/TP: Seconds .. Years at 0x04
+			if ( (tp || a) && time_regs_valid( r[ 4 ], r[ 5 ], r[ 7 ], r[ 8 ], r[ 9 ], r[ 10 ] ) )
+				return tp ? CHIP_PCF85063TP : CHIP_PCF85063A;
+
+			//	PCF85263A: _100th_seconds .. Years at 0x00. 
+			//	Its 0x12 and 0x13 can be same as 0x00 and 0x01 by chance (e.g. all 0 at 00:00:00), then the map above doesn't fit
+			if ( !tp && time_regs_valid( r[ 1 ], r[ 2 ], r[ 4 ], r[ 5 ], r[ 6 ], r[ 7 ] ) )
+				return CHIP_PCF85263A;
+
+			break;
+
+		case (0xDE >> 1):
+			//	PCF85053A: Seconds, Seconds_alarm, Minutes, Minutes_alarm, Hours, Hours_alarm, Day_of_the_Week, Day_of_the_Month, Month, Year
+			if ( dev.try_reg_r( 0x00, r, 10 ) )
+				return CHIP_NONE;
+
+			if ( time_regs_valid( r[ 0 ], r[ 2 ], r[ 7 ], r[ 6 ], r[ 8 ], r[ 9 ] ) )
+				return CHIP_PCF85053A;
+
+			break;
+	}
+
+	return CHIP_NONE;
+}
@@ -0,0 +1,158 @@
+#include "RTC_NXP.h"
+
+RTC_timebase::RTC_timebase( RTC_NXP& rtc, uint8_t period ) : 
+	rtc_dev( rtc ), tick_period( period ), edge_count( 0 ), edge_us( 0 ), tick_count( 0 ), sync( true ), 
+	prev_us( 0 ), rtc_sec( 0 ), n_ticks( 0 ), cb_func( NULL ), cb_interval( 1 ), cb_phase( 0 )
+{
+	reset_statistics();
+}
+
+RTC_timebase::~RTC_timebase()
+{
+}
+
+void RTC_timebase::begin( void )
+{
+	noInterrupts();
+	tick_count	= edge_count;
+	interrupts();
+	
+	n_ticks		= 0;
+	sync		= true;
+	reset_statistics();
+}
+
+void RTC_timebase::edge( void )
+{
+	edge_us		= micros();
+	edge_count++;
+}
+
+bool RTC_timebase::update( void )
+{
+	unsigned long	now_us	= micros();
+	unsigned long	e_us;
+	uint8_t			count;
+	
+	noInterrupts();
+	e_us	= edge_us;
+	count	= edge_count;
+	interrupts();
+	
+	uint8_t	n	= count - tick_count;
+	
+	if ( !n )
+		return false;
+
+	tick_count	 = count;
+	n_missed	+= n - 1;
+	
+	uint32_t	prev_sec	= rtc_sec;
+	bool		first		= sync;
+
+	if ( sync ) {
+		//	time read just after the edge: rounded down to the period
+		rtc_sec	 = rtc_dev.now32();
+		rtc_sec	-= rtc_sec % tick_period;
+		sync	 = false;
+	} else {
+		long	jitter	= (long)((e_us - prev_us) / n) - tick_period * 1000000L;
+		
+		j_min		 = (jitter < j_min) ? jitter : j_min;
+		j_max		 = (j_max < jitter) ? jitter : j_max;
+		j_sq_sum	+= (float)jitter * jitter;
+		n_jitter++;
+
+		rtc_sec		+= (uint32_t)tick_period * n;
+	}
+
+	unsigned long	latency	= now_us - e_us;
+
+	l_max	 = (l_max < latency) ? latency : l_max;
+	l_sum	+= latency;
+	n_latency++;
+
+	prev_us	 = e_us;
+	n_ticks	+= n;
+	
+	if ( !cb_func )
+		return true;
+
+	//	called once if callback time is crossed since last tick (exact match on first tick). 
+	//	Offset by (interval - phase) to count the boundaries without underflow
+	uint32_t	offset	= cb_interval - cb_phase;
+
+	if ( first ? ((rtc_sec % cb_interval) == cb_phase) : (((prev_sec + offset) / cb_interval) != ((rtc_sec + offset) / cb_interval)) )
+		cb_func( rtc_sec );
+	
+	return true;
+}
+
+void RTC_timebase::callback( callback_t cb, uint16_t interval, uint16_t phase )
+{
+	cb_func		= cb;
+	cb_interval	= interval ? interval : 1;
+	cb_phase	= phase % cb_interval;
+}
+
+void RTC_timebase::resync( void )
+{
+	sync	= true;
+}
+
+uint32_t RTC_timebase::ticks( void )
+{
+	return n_ticks;
+}
+
+uint32_t RTC_timebase::now32( void )
+{
+	return rtc_sec;
+}
+
+unsigned long RTC_timebase::edge_micros( void )
+{
+	return prev_us;
+}
+
+uint16_t RTC_timebase::missed( void )
+{
+	return n_missed;
+}
+
+long RTC_timebase::jitter_min( void )
+{
+	return n_jitter ? j_min : 0;
+}
+
+long RTC_timebase::jitter_max( void )
+{
+	return n_jitter ? j_max : 0;
+}
+
+float RTC_timebase::jitter_rms( void )
+{
+	return n_jitter ? sqrt( j_sq_sum / n_jitter ) : 0.0;
+}
+
+unsigned long RTC_timebase::latency_max( void )
+{
+	return l_max;
+}
+
+float RTC_timebase::latency_mean( void )
+{
+	return n_latency ? l_sum / n_latency : 0.0;
+}
+
+void RTC_timebase::reset_statistics( void )
+{
+	n_missed	= 0;
+	n_jitter	= 0;
+	j_min		= 0x7FFFFFFF;
+	j_max		= -j_min - 1;
+	j_sq_sum	= 0.0;
+	n_latency	= 0;
+	l_max		= 0;
+	l_sum		= 0.0;
+}
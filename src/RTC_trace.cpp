@@ -0,0 +1,86 @@
+#include "RTC_NXP.h"
+
+#if RTC_NXP_TRACE
+
+RTC_trace*	RTC_trace::active	= NULL;
+
+void RTC_trace::sink( RTC_trace* s )
+{
+	active	= s;
+}
+
+RTC_trace_buffer::RTC_trace_buffer( record* buffer, uint16_t size ) :
+	buf( buffer ), buf_size( size ), head( 0 ), count( 0 ), n_overwritten( 0 )
+{
+}
+
+RTC_trace_buffer::~RTC_trace_buffer()
+{
+}
+
+void RTC_trace_buffer::enter( const char* name, const void* dev )
+{
+	put( 'B', name, dev, 0 );
+}
+
+void RTC_trace_buffer::exit( const char* name, const void* dev )
+{
+	put( 'E', name, dev, 0 );
+}
+
+void RTC_trace_buffer::event( const char* name, const void* dev, uint32_t value )
+{
+	put( 'i', name, dev, value );
+}
+
+void RTC_trace_buffer::put( char type, const char* name, const void* dev, uint32_t value )
+{
+	record&	r	= buf[ head ];
+
+	r.us	= micros();
+	r.name	= name;
+	r.dev	= dev;
+	r.value	= value;
+	r.type	= type;
+
+	head	= (head + 1 == buf_size) ? 0 : head + 1;
+
+	if ( count < buf_size )
+		count++;
+	else
+		n_overwritten++;
+}
+
+void RTC_trace_buffer::dump( Print& out )
+{
+	uint16_t	i	= (head + buf_size - count) % buf_size;
+
+	for ( ; count; count-- )
+	{
+		record&	r	= buf[ i ];
+
+		out.print( r.us );
+		out.print( " " );
+		out.print( r.type );
+		out.print( " " );
+		out.print( r.name );
+		out.print( " 0x" );
+		out.print( (unsigned long)r.dev, HEX );
+		out.print( " " );
+		out.println( r.value );
+
+		i	= (i + 1 == buf_size) ? 0 : i + 1;
+	}
+}
+
+uint16_t RTC_trace_buffer::available( void )
+{
+	return count;
+}
+
+uint32_t RTC_trace_buffer::overwritten( void )
+{
+	return n_overwritten;
+}
+
+#endif	//	RTC_NXP_TRACE
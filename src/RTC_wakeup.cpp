@@ -0,0 +1,126 @@
+#include "RTC_NXP.h"
+
+#define	GUARD_S			2UL		//	margin for the alarm edge
+#define	POLL_LEAD_US	20000UL	//	100th-seconds register is tracked from this time before the target
+
+RTC_wakeup::RTC_wakeup( RTC_NXP& rtc, idle_t idle ) : 
+	rtc_dev( rtc ), idle_func( idle ), edge_count( 0 ), edge_us( 0 )
+{
+}
+
+RTC_wakeup::~RTC_wakeup()
+{
+}
+
+void RTC_wakeup::edge( void )
+{
+	edge_us		= micros();
+	edge_count++;
+}
+
+void RTC_wakeup::idle( idle_t func )
+{
+	idle_func	= func;
+}
+
+unsigned long RTC_wakeup::edge_micros( void )
+{
+	return edge_us;
+}
+
+bool RTC_wakeup::wait_until( time_t t, uint8_t centiseconds )
+{
+	//	time_t to seconds since 2000 in same way as time() is converted
+	uint32_t	target	= t - RTC_NXP::time_2000();
+	bool		fine	= rtc_dev.has_hundredths();
+	uint8_t		h		= 0;
+	uint32_t	now		= fine ? rtc_dev.now32( &h ) : rtc_dev.now32();
+
+	if ( (target < now) || ((target == now) && (!fine || (centiseconds < h))) )
+		return false;
+
+	unsigned long	edge_at;
+
+	if ( now < target ) {
+		uint8_t	count;
+
+		noInterrupts();
+		count	= edge_count;
+		interrupts();
+
+		rtc_dev.int_clear();
+		rtc_dev.alarm_at( t );
+
+		//	alarm is missed if the second was changed while setting
+		now	= fine ? rtc_dev.now32( &h ) : rtc_dev.now32();
+
+		bool	detected	= (now < target) && wait_edge( count, target, target - now + GUARD_S );
+
+		rtc_dev.alarm_disable();
+		rtc_dev.int_clear();
+
+		if ( detected ) {
+			edge_at	= edge_us;
+		} else {
+			//	continue only if it is in the target second and the phase is known
+			if ( !fine || (now != target) || (centiseconds < h) )
+				return false;
+
+			edge_at	= micros() - h * 10000UL;
+		}
+	} else {
+		edge_at	= micros() - h * 10000UL;
+	}
+
+	if ( !centiseconds )
+		return true;
+
+	unsigned long	offset	= centiseconds * 10000UL;
+
+	if ( !fine ) {
+		while ( (micros() - edge_at) < offset )
+			;
+		return true;
+	}
+
+	//	wait by micros() for most part, then track the RTC
+	if ( POLL_LEAD_US < offset )
+		while ( (micros() - edge_at) < (offset - POLL_LEAD_US) )
+			;
+
+	do {
+		now	= rtc_dev.now32( &h );
+	} while ( (now == target) && (h < centiseconds) && ((micros() - edge_at) < (offset + POLL_LEAD_US)) );
+
+	return (target < now) || (centiseconds <= h);
+}
+
+bool RTC_wakeup::wait_edge( uint8_t count, uint32_t target, uint32_t timeout_s )
+{
+	unsigned long	start	= millis();
+
+	for ( ;; ) {
+		if ( edge_count != count ) {
+			//	other interrupts on same pin can come. Check the time is reached
+			count	= edge_count;
+
+			if ( target <= rtc_dev.now32() )
+				return true;
+
+			//	early edge: alarm without day/month matched before the target (PCF85053A has no DAY alarm). 
+			//	Flags are cleared to release the INT and get next match. Alarm setting is kept
+			rtc_dev.int_clear();
+		}
+
+		//	timeout is counted in seconds to avoid overflow of milliseconds in long waits
+		if ( 1000UL <= (millis() - start) ) {
+			start	+= 1000UL;
+
+			if ( !--timeout_s )
+				return false;
+		}
+
+		if ( idle_func )
+			idle_func();
+	}
+}
@@ -1,49 +1,130 @@
 #include "RTC_NXP.h"
 
+SPI_for_RTC::SPI_for_RTC( uint32_t max_clock ) : max_khz( max_clock / 1000 ), clk_khz( 0 )
+{
+}
+
+void SPI_for_RTC::bus_profile( RTC_NXP::bus_speed speed )
+{
+	uint16_t	khz	= (RTC_NXP::BUS_SPEED_STANDARD == speed) ? 1000 : (RTC_NXP::BUS_SPEED_FAST == speed) ? 4000 : max_khz;
+
+	clk_khz		= khz < max_khz ? khz : max_khz;
+	settings	= SPISettings( bus_clock(), MSBFIRST, SPI_MODE0 );
+}
+
+uint32_t SPI_for_RTC::bus_clock( void )
+{
+	return clk_khz * 1000UL;
+}
+
 void SPI_for_RTC::txrx( uint8_t *data, int size )
 {
+	if ( RTC_bus_recorder::recording() )
+	{
+		uint8_t	tx[ size ];
+		
+		memcpy( tx, data, size );
+		transfer( data, size );
+		RTC_bus_recorder::transfer( tx, data, size );
+		
+		return;
+	}
+	
+	transfer( data, size );
+}
+
+void SPI_for_RTC::transfer( uint8_t *data, int size )
+{
+	if ( clk_khz )
+		SPI.beginTransaction( settings );
+
 	digitalWrite( SS, LOW );
 	SPI.transfer( data, size );
 	digitalWrite( SS, HIGH );
+
+	if ( clk_khz )
+		SPI.endTransaction();
 }
 
-void SPI_for_RTC::reg_w( uint8_t reg_adr, uint8_t *data, int size )
+void SPI_for_RTC::frame( uint8_t cmd, const uint8_t *tx, uint8_t *rx, int size )
 {
-	uint8_t	v[ size + 1 ];
-	
-	v[ 0 ]	= reg_adr;
-	memcpy( v + 1, data, size );
+	if ( RTC_bus_recorder::recording() )
+	{
+		uint8_t	t[ size + 1 ];
+		uint8_t	r[ size + 1 ];
+		
+		t[ 0 ]	= cmd;
+		if ( tx )
+			memcpy( t + 1, tx, size );
+		else
+			memset( t + 1, 0xFF, size );
+
+		frame_transfer( cmd, tx, rx, size );
+
+		r[ 0 ]	= 0xFF;
+		if ( rx )
+			memcpy( r + 1, rx, size );
+		else
+			memset( r + 1, 0xFF, size );
+
+		RTC_bus_recorder::transfer( t, r, size + 1 );
+		
+		return;
+	}
 	
-	txrx( v, sizeof( v ) );
+	frame_transfer( cmd, tx, rx, size );
+}
+
+void SPI_for_RTC::frame_transfer( uint8_t cmd, const uint8_t *tx, uint8_t *rx, int size )
+{
+	if ( clk_khz )
+		SPI.beginTransaction( settings );
+
+	digitalWrite( SS, LOW );
+
+#if defined( ARDUINO_ARCH_ESP32 ) || defined( RTC_NXP_HOST )
+	SPI.transferBytes( &cmd, NULL, 1 );
+	SPI.transferBytes( tx, rx, size );
+#else
+	SPI.transfer( cmd );
+
+	for ( int i = 0; i < size; i++ )
+	{
+		uint8_t	v	= SPI.transfer( tx ? tx[ i ] : 0xFF );
+		
+		if ( rx )
+			rx[ i ]	= v;
+	}
+#endif
+
+	digitalWrite( SS, HIGH );
+
+	if ( clk_khz )
+		SPI.endTransaction();
+}
+
+void SPI_for_RTC::reg_w( uint8_t reg_adr, uint8_t *data, int size )
+{
+	frame( reg_adr, data, NULL, size );
 }
 
 void SPI_for_RTC::reg_w( uint8_t reg_adr, uint8_t data )
 {
-	uint8_t	v[]	= { reg_adr, data };
-	
-	txrx( v, sizeof( v ) );
+	frame( reg_adr, &data, NULL, 1 );
 }
 
 void SPI_for_RTC::reg_r( uint8_t reg_adr, uint8_t *data, int size )
 {
-	uint8_t	v[ size + 1 ];
-	
-	for ( int i = 0; i < size + 1; i++ ) v[ i ]	= 0xFF;
-	
-	v[ 0 ]	= (uint8_t)(reg_adr | 0x80);
-	
-	txrx( v, sizeof( v ) );
-	
-	memcpy( data, v + 1, size );
+	frame( (uint8_t)(reg_adr | 0x80), NULL, data, size );
 }
 
 uint8_t	SPI_for_RTC::reg_r( uint8_t reg_adr )
 {
-	uint8_t	v[]	= { (uint8_t)(reg_adr | 0x80), 0xFF };
+	uint8_t	v;
 	
-	txrx( v, sizeof( v ) );
+	frame( (uint8_t)(reg_adr | 0x80), NULL, &v, 1 );
 	
-	return v[ 1 ];
+	return v;
 }
 
 void SPI_for_RTC::write_r8( uint8_t reg, uint8_t val )
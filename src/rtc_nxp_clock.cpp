@@ -0,0 +1,65 @@
+#include "RTC_NXP.h"
+
+#if RTC_NXP_CHRONO
+
+#if RTC_NXP_MULTITHREAD
+static std::mutex	clock_lock;
+#define	CLOCK_GUARD()	std::lock_guard<std::mutex>	clock_guard( clock_lock )
+#else
+#define	CLOCK_GUARD()
+#endif
+
+RTC_monotonic	*rtc_nxp_clock::mono_p		= NULL;
+uint64_t		rtc_nxp_clock::interval_us	= 0;
+uint64_t		rtc_nxp_clock::next_sync	= 0;
+uint32_t		rtc_nxp_clock::n_syncs		= 0;
+
+const bool		rtc_nxp_clock::is_steady;
+
+void rtc_nxp_clock::source( RTC_monotonic& mono, uint16_t sync_interval_s )
+{
+	CLOCK_GUARD();
+
+	mono_p		= &mono;
+	interval_us	= sync_interval_s * 1000000ULL;
+	next_sync	= mono.now_us() + interval_us;
+	n_syncs		= 0;
+}
+
+rtc_nxp_clock::time_point rtc_nxp_clock::now( void )
+{
+	CLOCK_GUARD();
+
+	if ( !mono_p )
+		return time_point();
+
+	uint64_t	t	= mono_p->now_us();
+
+	if ( interval_us && (next_sync <= t) )
+	{
+		mono_p->sync();
+		n_syncs++;
+		
+		next_sync	= t + interval_us;
+		t			= mono_p->now_us();
+	}
+
+	return time_point( duration( (rep)t ) );
+}
+
+uint32_t rtc_nxp_clock::syncs( void )
+{
+	return n_syncs;
+}
+
+time_t rtc_nxp_clock::to_time_t( const time_point& t ) noexcept
+{
+	return (time_t)(std::chrono::duration_cast<std::chrono::seconds>( t.time_since_epoch() ).count() + RTC_NXP::time_2000());
+}
+
+rtc_nxp_clock::time_point rtc_nxp_clock::from_time_t( time_t t ) noexcept
+{
+	return time_point( std::chrono::duration_cast<duration>( std::chrono::seconds( t - RTC_NXP::time_2000() ) ) );
+}
+
+#endif	//	RTC_NXP_CHRONO
@@ -0,0 +1 @@
+#include <RTC_NXP.h>